@@ -2,14 +2,17 @@
  * David Mally, Richard Roberts
  * Card.h
  * Header file for Card class. Also
- * defines a card type enum
+ * defines a card type enum and the
+ * compact CardId used to refer to cards.
  */
 
 #ifndef __CARD_H__
 #define __CARD_H__
 
+#include <cstdint>
 #include <string>
 #include "Defs.h"
+#include "Task.h"
 
 #define DEF_POINTS  0
 #define DEF_COST   -1
@@ -30,43 +33,107 @@ enum CardType {
     BASE
 };
 
+// Cards are passed around as an index into lookup::CARD_TABLE.
+// The order here must match the order of the table in CardLookup.cpp.
+typedef uint8_t CardId;
 
+enum : CardId {
+    /* VICTORY CARDS */
+    CARD_ESTATE,
+    CARD_DUCHY,
+    CARD_PROVINCE,
+    CARD_CURSE,
+
+    /* TREASURE CARDS */
+    CARD_COPPER,
+    CARD_SILVER,
+    CARD_GOLD,
+
+    /* KINGDOM CARDS */
+    CARD_CELLAR,
+    CARD_CHAPEL,
+    CARD_MOAT,
+    CARD_CHANCELLOR,
+    CARD_VILLAGE,
+    CARD_WOODCUTTER,
+    CARD_WORKSHOP,
+    CARD_BUREAUCRAT,
+    CARD_FEAST,
+    CARD_GARDENS,
+    CARD_MILITIA,
+    CARD_MONEYLENDER,
+    CARD_REMODEL,
+    CARD_SMITHY,
+    CARD_SPY,
+    CARD_THIEF,
+    CARD_THRONEROOM,
+    CARD_COUNCILROOM,
+    CARD_FESTIVAL,
+    CARD_LABORATORY,
+    CARD_LIBRARY,
+    CARD_MARKET,
+    CARD_MINE,
+    CARD_WITCH,
+    CARD_ADVENTURER,
+
+    NUM_CARDS
+};
+
+// Returned by piles when there is no card to hand out
+const CardId NO_CARD = 0xFF;
+
+// A set of card kinds, one bit per CardId
+typedef uint32_t CardMask;
+static_assert(NUM_CARDS <= 32, "CardMask needs a bit per card kind");
+
+#define CARD_BIT(card) ((CardMask)1 << (card))
+// Every card kind
+#define ALL_CARDS ((CardMask)(((uint64_t)1 << NUM_CARDS) - 1))
+
+// Plays a card's effect for player 1 or 2, and ends with whether the card
+// trashed itself
+typedef Task<bool> (*CardEffect)(struct stateBlock *state, bool p1);
+
+// Immutable description of a card. There is exactly one instance per
+// CardId, living in lookup::CARD_TABLE; piles only ever store CardIds.
 class Card {
     private:
         int m_cost;
-        std::string m_name;
+        const char *m_name;
         CardType m_type;
-        std::string m_info;
-        bool (*m_effect)(struct stateBlock *state, bool p1);
-    protected:
+        const char *m_info;
+        CardEffect m_effect;
         int m_actions;
         int m_buys;
         int m_cards;
         int m_coins;
         int m_points;
-        void SetActions(int actions);
-        void SetBuys(int buys);
-        void SetCards(int cards);
-        void SetCoins(int coins);
-        void SetPoints(int points);
     public:
-        Card(int cost = DEF_COST, std::string name = DEF_NAME,
-             CardType type = BASE, std::string info = "",
-             bool (*effect)(struct stateBlock *, bool) = NULL);
-        int GetCost(void);
-        std::string GetName(void);
-        CardType GetType(void);
-        bool operator==(Card other);
-        virtual int GetPoints(void);
-        virtual std::string ToString(void);
-        int GetActions(void);
-        int GetBuys(void);
-        int GetCards(void);
-        int GetCoins(void);
-        std::string GetInfo(void);
-        void SetEffect(bool (*effect)(struct stateBlock *state, bool p1));
-        void *GetEffect(void);
-        bool PlayEffect(struct stateBlock *state, bool p1);
+        constexpr Card(int cost = DEF_COST, const char *name = DEF_NAME,
+                       CardType type = BASE, const char *info = "",
+                       CardEffect effect = NULL,
+                       int actions = DEF_ACTIONS, int buys = DEF_BUYS,
+                       int cards = DEF_CARDS, int coins = DEF_COINS,
+                       int points = DEF_POINTS)
+            : m_cost(cost), m_name(name), m_type(type), m_info(info),
+              m_effect(effect), m_actions(actions), m_buys(buys),
+              m_cards(cards), m_coins(coins), m_points(points) {}
+        int GetCost(void) const { return m_cost; }
+        constexpr const char *GetName(void) const { return m_name; }
+        constexpr CardType GetType(void) const { return m_type; }
+        int GetPoints(void) const { return m_points; }
+        std::string ToString(void) const;
+        int GetActions(void) const { return m_actions; }
+        int GetBuys(void) const { return m_buys; }
+        int GetCards(void) const { return m_cards; }
+        int GetCoins(void) const { return m_coins; }
+        // True for action, attack and reaction cards
+        constexpr bool IsAction(void) const {
+            return m_type == ACTION || m_type == ATTACK || m_type == REACTION;
+        }
+        std::string GetInfo(void) const;
+        CardEffect GetEffect(void) const { return m_effect; }
+        Task<bool> PlayEffect(struct stateBlock *state, bool p1) const;
 };
 
 #endif
@@ -7,10 +7,13 @@
  * of all action cards.
  */
 
+#include <cstdint>
 #include <vector>
 #include <iostream>
 #include <limits>
 #include "CardLookup.h"
+#include "Decision.h"
+#include "GameState.h"
 
 /* Clears cin of error flags and flushes the stdin buffer */
 void lookup::ClearCinError(void) {
@@ -24,298 +27,236 @@ void lookup::CheckInvalidChoice(size_t pileSize, int *choicePtr) {
     if(std::cin.fail() || *choicePtr < DEF_CHOICE ||
       *choicePtr > (int)pileSize - 1) {
         lookup::ClearCinError();
-        std::cout << "Invalid choice." << std::endl;
+        game_state::Out() << "Invalid choice." << std::endl;
         *choicePtr = BAD_CHOICE;
     }
 }
 
-bool lookup::CellarEffect(struct stateBlock *state, bool p1) {
-    Pile *hand = p1 ? state->p1->HandPtr() : state->p2->HandPtr();
-    Pile *discard = p1 ? state->p1->DiscardPtr() : state->p2->DiscardPtr();
-    Pile *deck = p1 ? state->p1->DeckPtr() : state->p2->DeckPtr();
-    int numDiscarded = 0;
-    size_t handSize = hand->Size();
-    for(size_t i = 0; i < handSize; i++) {
-        hand->PrintPileAsHand();
-        int choice = BAD_CHOICE;
-        while(choice < DEF_CHOICE) {
-            std::cout << "Choose a card to discard (0 - "
-                      << hand->GetCards().size() - 1
-                      << ") or -1 to discard none: ";
-            std::cin >> choice;
-            CheckInvalidChoice(hand->GetCards().size(), &choice);
-        }
-        if(choice >= 0) {
-            hand->Move(choice, discard);
-            numDiscarded++;
-        }
-    }
-    for(int i = 0; i < numDiscarded; i++) {
-        if(deck->Size() > 0) {
-            hand->TopDeck(deck->DrawTopCard());
-        }
+Task<bool> lookup::CellarEffect(struct stateBlock *state, bool p1) {
+    Player *currPlayer = p1 ? state->p1 : state->p2;
+    Pile *hand = currPlayer->HandPtr();
+    Pile *discard = currPlayer->DiscardPtr();
+    std::vector<int> ownPicks;
+    std::vector<int> &picks = state->picks != NULL ? *state->picks
+                                                   : ownPicks;
+    co_await decision::ManyFromHand(*state, p1, DEC_CELLAR, *hand,
+                                    ALL_CARDS, 0, hand->Size(), &picks);
+    // Picks come highest index first, so each move leaves the rest in place
+    for(int idx : picks) {
+        hand->Move(idx, discard);
     }
-    return false;
+    // Like any draw, this shuffles the discard pile (the cards just
+    // discarded too) into an empty deck
+    currPlayer->DrawN(picks.size());
+    co_return false;
 }
 
-bool lookup::ChapelEffect(struct stateBlock *state, bool p1) {
+Task<bool> lookup::ChapelEffect(struct stateBlock *state, bool p1) {
     Pile *hand = p1 ? state->p1->HandPtr() : state->p2->HandPtr();
-    int choice = BAD_CHOICE;
-    for(size_t i = 0; i < LIM_CHAPEL; i++) {
-        hand->PrintPileAsHand();
-        choice = BAD_CHOICE;
-        while(choice == BAD_CHOICE) {
-            std::cout << "Choose a card to trash (0 - "
-                      << hand->GetCards().size() - 1
-                      << ") or -1 to trash none: ";
-            std::cin >> choice;
-            CheckInvalidChoice(hand->GetCards().size(), &choice);
-        }
-        if(choice >= 0) {
-            hand->Move(choice, state->trash);
-        }
-        if(choice == DEF_CHOICE) {
-            break;
-        }
+    std::vector<int> ownPicks;
+    std::vector<int> &picks = state->picks != NULL ? *state->picks
+                                                   : ownPicks;
+    co_await decision::ManyFromHand(*state, p1, DEC_CHAPEL, *hand,
+                                    ALL_CARDS, 0, LIM_CHAPEL, &picks);
+    for(int idx : picks) {
+        hand->Move(idx, state->trash);
     }
-    return false;
+    co_return false;
 }
 
-bool lookup::ChancellorEffect(struct stateBlock *state, bool p1) {
+Task<bool> lookup::ChancellorEffect(struct stateBlock *state, bool p1) {
     Pile *discard = p1 ? state->p1->DiscardPtr() : state->p2->DiscardPtr();
     Pile *deck = p1 ? state->p1->DeckPtr() : state->p2->DeckPtr();
-    std::string cmd;
-    std::cout << "Put deck -> discard? (y/n) ";
-    std::cin >> cmd;
-    if(cmd == YES) {
+    if(co_await decision::YesNo(*state, p1, DEC_CHANCELLOR,
+                                CARD_CHANCELLOR)) {
         discard->TakeAllFrom(deck);
-        std::cout << std::endl
-                  << "Discarded deck." << std::endl;
+        game_state::Out() << std::endl
+                          << "Discarded deck." << std::endl;
     } else {
-        std::cout << std::endl
-                  << "Keeping deck." << std::endl;
+        game_state::Out() << std::endl
+                          << "Keeping deck." << std::endl;
     }
-    return false;
+    co_return false;
 }
 
-bool lookup::WorkshopEffect(struct stateBlock *state, bool p1) {
+Task<bool> lookup::WorkshopEffect(struct stateBlock *state, bool p1) {
     Pile *discard = p1 ? state->p1->DiscardPtr() : state->p2->DiscardPtr();
-    std::string cmd;
-    std::cout << "Choose a card with cost <= $4:" << std::endl;
-    for(size_t i = 0; i < state->kingdom->size(); i++) {
-        if(state->kingdom->at(i).GetTopCard()->GetCost() <= LIM_WORKSHOP) {
-            std::cout << state->kingdom->at(i).GetTopCard()->GetName()
-                      << std::endl;
-        }
-    }
-    bool validResponse = false;
-    while(!validResponse) {
-        std::cout << "Name a card: ";
-        std::cin >> cmd;
-        for(size_t i = 0; i < state->kingdom->size(); i++) {
-            if(state->kingdom->at(i).GetTopCard()->GetName() == cmd &&
-               state->kingdom->at(i).GetTopCard()->GetCost() <= LIM_WORKSHOP) {
-                state->kingdom->at(i).Move(0, discard);
-                validResponse = true;
-            }
-        }
+    int idx = co_await decision::FromSupply(*state, p1, DEC_WORKSHOP,
+                                            ALL_CARDS, LIM_WORKSHOP, false);
+    if(idx != DEF_CHOICE) {
+        state->kingdom->Take(idx, discard);
     }
-    return false;
+    co_return false;
 }
 
-bool lookup::BureaucratEffect(struct stateBlock *state, bool p1) {
+Task<bool> lookup::BureaucratEffect(struct stateBlock *state, bool p1) {
     Pile *deck = p1 ? state->p1->DeckPtr() : state->p2->DeckPtr();
     Pile *otherHand = p1 ? state->p2->HandPtr() : state->p1->HandPtr();
     Pile *otherDeck = p1 ? state->p2->DeckPtr() : state->p1->DeckPtr();
 
     // Topdeck a silver
-    for(size_t i = 0; i < state->kingdom->size(); i++) {
-        if(state->kingdom->at(i).GetName() == "silver") {
-            state->kingdom->at(i).Move(0, deck);
-        }
+    int silverIdx = state->kingdom->IndexOf(CARD_SILVER);
+    if(silverIdx != CARD_NOT_FOUND) {
+        state->kingdom->Take(silverIdx, deck);
     }
 
     // Opponent reveals a victory card and topdecks it
     for(size_t i = 0; i < otherHand->Size(); i++) {
-        if(otherHand->At(i)->GetPoints() > 0) {
+        if(GetCard(otherHand->At(i)).GetPoints() > 0) {
             otherHand->Move(i, otherDeck);
-            return false;
+            co_return false;
         }
     }
-    return false;
+    co_return false;
 }
 
-bool lookup::FeastEffect(struct stateBlock *state, bool p1) {
+Task<bool> lookup::FeastEffect(struct stateBlock *state, bool p1) {
     //Trash self
     //Gain card costing up to 5
     Player *currPlayer = p1 ? state->p1 : state->p2;
-    std::cout << "Gain a card costing up to $5:" << std::endl;
-    std::vector<Pile> *kingdom = state->kingdom;
-    for(size_t i = 0; i < kingdom->size(); i++) {
-        std::cout << i << ": "
-                  << kingdom->at(i).GetTopCard()->ToString() << std::endl;
-    }
-    int idx = DEF_CHOICE;
-    while(idx < 0) {
-        std::cin >> idx;
-        CheckInvalidChoice(kingdom->size(), &idx);
-        if(kingdom->at(idx).GetTopCard()->GetCost() > LIM_FEAST) {
-            std::cout << "Invalid choice. Card must cost <= $5."
-                      << std::endl;
-            idx = DEF_CHOICE;
-        } else {
-            currPlayer->AddToDiscard(kingdom->at(idx).DrawTopCard());
-        }
+    int idx = co_await decision::FromSupply(*state, p1, DEC_FEAST,
+                                            ALL_CARDS, LIM_FEAST, false);
+    if(idx != DEF_CHOICE) {
+        currPlayer->AddToDiscard(state->kingdom->Draw(idx));
     }
-    return true;
+    co_return true;
 }
 
-bool lookup::MilitiaEffect(struct stateBlock *state, bool p1) {
+Task<bool> lookup::MilitiaEffect(struct stateBlock *state, bool p1) {
     // Opponent discards down to 3 cards
     Player *otherPlayer = p1 ? state->p2 : state->p1;
     char otherPlayerNum = p1 ? '2' : '1';
-    std::cout << "Player " << otherPlayerNum
-              << ", discard down to 3 cards."
-              << std::endl;
-    while(otherPlayer->HandPtr()->Size() > LIM_MILITIA) {
-        int idx = DEF_CHOICE;
-        std::cout << "Choose card(s) to discard:" << std::endl;
-        otherPlayer->HandPtr()->PrintPileAsHand();
-        while(idx < 0 || idx > (int)otherPlayer->GetHand().Size() - 1) {
-            std::cin >> idx;
-            CheckInvalidChoice(otherPlayer->HandPtr()->Size(), &idx);
-        }
+    game_state::Out() << "Player " << otherPlayerNum
+                      << ", discard down to 3 cards."
+                      << std::endl;
+    const Pile &otherHand = otherPlayer->GetHand();
+    int numDiscards = (int)otherHand.Size() - LIM_MILITIA;
+    std::vector<int> ownPicks;
+    std::vector<int> &picks = state->picks != NULL ? *state->picks
+                                                   : ownPicks;
+    // The attacked player makes this choice
+    co_await decision::ManyFromHand(*state, !p1, DEC_MILITIA, otherHand,
+                                    ALL_CARDS, numDiscards, numDiscards,
+                                    &picks);
+    for(int idx : picks) {
         otherPlayer->DiscardCard(idx);
     }
-    return false;
+    co_return false;
 }
-bool lookup::MoneylenderEffect(struct stateBlock *state, bool p1) {
+Task<bool> lookup::MoneylenderEffect(struct stateBlock *state, bool p1) {
     // Trash a copper and gain + $3
     Player *currPlayer = p1 ? state->p1 : state->p2;
-    std::string cmd;
-    std::cout << "Trash a copper and gain $3? (y/n)" << std::endl;
-    std::cin >> cmd;
-    if(cmd == YES) {
-        int idx = currPlayer->GetHand().LookThrough(new Card(lookup::copper));
-        if(idx > DEF_CHOICE) {
-            currPlayer->TrashCard(idx, state->trash);
-            currPlayer->AddCoins(COINS_MONEYLENDER);
-        }
+    if(!currPlayer->GetHand().Contains(CARD_COPPER)) {
+        co_return false;
+    }
+    if(co_await decision::YesNo(*state, p1, DEC_MONEYLENDER, CARD_COPPER)) {
+        int idx = currPlayer->GetHand().LookThrough(CARD_COPPER);
+        currPlayer->TrashCard(idx, state->trash);
+        currPlayer->AddCoins(COINS_MONEYLENDER);
     }
-    return false;
+    co_return false;
 }
 
-bool lookup::RemodelEffect(struct stateBlock *state, bool p1) {
+Task<bool> lookup::RemodelEffect(struct stateBlock *state, bool p1) {
     // Trash a card and gain a card costing up to $2 more than it
     Player *currPlayer = p1 ? state->p1 : state->p2;
-    Pile *trash = state->trash;
-    std::vector<Pile> *kingdom = state->kingdom;
-    int idx = DEF_CHOICE;
-    currPlayer->GetHand().PrintPileAsHand();
-    while(idx < 0) {
-        std::cin >> idx;
-        CheckInvalidChoice(currPlayer->GetHand().Size(), &idx);
-    }
-    int cardCost = currPlayer->GetHand().At(idx)->GetCost();
-    currPlayer->HandPtr()->Move(idx, trash);
-    for(size_t i = 0; i < kingdom->size(); i++) {
-        std::cout << i << ": " << kingdom->at(i).GetTopCard()->ToString()
-                  << std::endl;
-    }
-    idx = DEF_CHOICE;
-    while(idx < 0) {
-        std::cout << "Choose a card from the kingdom costing up to $"
-                  << cardCost + LIM_REMODEL << ":" << std::endl;
-        std::cin >> idx;
-        CheckInvalidChoice(kingdom->size(), &idx);
-        if(kingdom->at(idx).GetTopCard()->GetCost() >
-           cardCost + LIM_REMODEL) {
-            idx = DEF_CHOICE;
-        }
+    int idx = co_await decision::FromHand(*state, p1, DEC_REMODEL_TRASH,
+                                          currPlayer->GetHand(), ALL_CARDS,
+                                          false);
+    if(idx == DEF_CHOICE) {
+        co_return false;
     }
-    currPlayer->AddToDiscard(kingdom->at(idx).DrawTopCard());
-    return false;
+    int cardCost = GetCard(currPlayer->GetHand().At(idx)).GetCost();
+    currPlayer->HandPtr()->Move(idx, state->trash);
+    idx = co_await decision::FromSupply(*state, p1, DEC_REMODEL_GAIN,
+                                        ALL_CARDS, cardCost + LIM_REMODEL,
+                                        false);
+    if(idx != DEF_CHOICE) {
+        currPlayer->AddToDiscard(state->kingdom->Draw(idx));
+    }
+    co_return false;
 }
 
-bool lookup::SpyEffect(struct stateBlock *state, bool p1) {
+Task<bool> lookup::SpyEffect(struct stateBlock *state, bool p1) {
     // all players reveal top card of deck and either discard
     // or put back, your choice
     Player *currPlayer = p1 ? state->p1 : state->p2;
     Player *otherPlayer = p1 ? state->p2 : state->p1;
-    std::string cmd;
-    Card *currCard = currPlayer->GetDeck().GetTopCard();
-    Card *otherCard = otherPlayer->GetDeck().GetTopCard();
-    std::cout << "Your top card: " << currCard->GetName() << std::endl;
-    std::cout << "Opponent's top card: " << otherCard->GetName() << std::endl;
-    std::cout << std::endl << "Discard your card? (y/n)" << std::endl;
-    std::cin >> cmd;
-    if(cmd == YES) {
-        currPlayer->DeckPtr()->Move(currPlayer->DeckPtr()->Size() - 1,
-                                    currPlayer->DiscardPtr());
-    }
-    std::cout << std::endl << "Discard your opponent's card? (y/n)" << std::endl;
-    std::cin >> cmd;
-    if(cmd == YES) {
-        otherPlayer->DeckPtr()->Move(otherPlayer->DeckPtr()->Size() - 1,
-                                     otherPlayer->DiscardPtr());
-    }
-    return false;
+    // An empty deck reveals nothing, so there's nothing to decide
+    if(currPlayer->GetDeck().Size() > 0) {
+        CardId currCard = currPlayer->GetDeck().GetTopCard();
+        game_state::Out() << "Your top card: " << GetCard(currCard).GetName()
+                          << std::endl;
+        if(co_await decision::YesNo(*state, p1, DEC_SPY_SELF, currCard)) {
+            currPlayer->DeckPtr()->Move(currPlayer->DeckPtr()->Size() - 1,
+                                        currPlayer->DiscardPtr());
+        }
+    }
+    if(otherPlayer->GetDeck().Size() > 0) {
+        CardId otherCard = otherPlayer->GetDeck().GetTopCard();
+        game_state::Out() << "Opponent's top card: "
+                          << GetCard(otherCard).GetName() << std::endl;
+        if(co_await decision::YesNo(*state, p1, DEC_SPY_OTHER, otherCard)) {
+            otherPlayer->DeckPtr()->Move(otherPlayer->DeckPtr()->Size() - 1,
+                                         otherPlayer->DiscardPtr());
+        }
+    }
+    co_return false;
 }
 
-bool lookup::ThiefEffect(struct stateBlock *state, bool p1) {
+Task<bool> lookup::ThiefEffect(struct stateBlock *state, bool p1) {
     // Other player reveals top 2 cards of deck, trashes one
     // of your choice if a treasure, and then discards the other.
     // You may gain the trashed card if you wish.
     Player *currPlayer = p1 ? state->p1 : state->p2;
     Player *otherPlayer = p1 ? state->p2 : state->p1;
     Pile *trash = state->trash;
-    std::string cmd;
-    Card *otherCard1 = otherPlayer->DeckPtr()->DrawTopCard();
-    Card *otherCard2 = otherPlayer->DeckPtr()->DrawTopCard();
-    std::cout << "Opponent's top 2 cards: " << std::endl
-              << otherCard1->GetName() << std::endl
-              << otherCard2->GetName() << std::endl;
+    CardId otherCard1 = otherPlayer->DeckPtr()->DrawTopCard();
+    CardId otherCard2 = otherPlayer->DeckPtr()->DrawTopCard();
+    // A short deck reveals fewer cards; a missing one (NO_CARD) is never
+    // a treasure and isn't discarded, so nothing is asked about it
+    game_state::Out() << "Opponent's top 2 cards: " << std::endl;
+    for(CardId card : {otherCard1, otherCard2}) {
+        if(card != NO_CARD) {
+            game_state::Out() << GetCard(card).GetName() << std::endl;
+        }
+    }
     bool trashed = false;
-    if(otherCard1->GetType() == TREASURE_C) {
-        std::cout << "Trash " << otherCard1->GetName() << "? (y/n)"
-                  << std::endl;
-        std::cin >> cmd;
-        if(cmd == YES) {
+    if(otherCard1 != NO_CARD && GetCard(otherCard1).GetType() == TREASURE_C) {
+        if(co_await decision::YesNo(*state, p1, DEC_THIEF_TRASH,
+                                    otherCard1)) {
             // Trash and optionally gain the first card?
             trashed = true;
-            std::cout << "Do you wish to gain the trashed card? (y/n)"
-                      << std::endl;
-            std::cin >> cmd;
-            if(cmd == YES) {
+            if(co_await decision::YesNo(*state, p1, DEC_THIEF_GAIN,
+                                        otherCard1)) {
                 currPlayer->AddToDiscard(otherCard1);
             } else {
                 trash->TopDeck(otherCard1);
             }
             // Discard the 2nd card, since we already trashed one
-            otherPlayer->AddToDiscard(otherCard2);
-            return false;
+            if(otherCard2 != NO_CARD) {
+                otherPlayer->AddToDiscard(otherCard2);
+            }
+            co_return false;
         } else {
             // If we choose not to trash, discard the card
             otherPlayer->AddToDiscard(otherCard1);
         }
-    } else {
+    } else if(otherCard1 != NO_CARD) {
         // If the first card is not a treasure, we must discard it
         otherPlayer->AddToDiscard(otherCard1);
     }
 
     // If the 2nd card is a treasure and we didn't trash the first one,
     // we may choose to trash it
-    if(otherCard2->GetType() == TREASURE_C && !trashed) {
-        std::cout << "Trash " << otherCard2->GetName() << "? (y/n)"
-                  << std::endl;
-        std::cin >> cmd;
-        if(cmd == YES) {
+    if(otherCard2 != NO_CARD && GetCard(otherCard2).GetType() == TREASURE_C &&
+       !trashed) {
+        if(co_await decision::YesNo(*state, p1, DEC_THIEF_TRASH,
+                                    otherCard2)) {
             // Trash and optionally gain the first card?
             trashed = true;
-            std::cout << "Do you wish to gain the trashed card? (y/n)"
-                      << std::endl;
-            std::cin >> cmd;
-            if(cmd == YES) {
+            if(co_await decision::YesNo(*state, p1, DEC_THIEF_GAIN,
+                                        otherCard2)) {
                 currPlayer->AddToDiscard(otherCard2);
             } else {
                 trash->TopDeck(otherCard2);
@@ -323,189 +264,305 @@ bool lookup::ThiefEffect(struct stateBlock *state, bool p1) {
         } else {
             otherPlayer->AddToDiscard(otherCard2);
         }
-    } else {
+    } else if(otherCard2 != NO_CARD) {
         // If the second card is not a treasure, we must discard it
         otherPlayer->AddToDiscard(otherCard2);
     }
-    return false;
+    co_return false;
 }
 
-bool lookup::ThroneroomEffect(struct stateBlock *state, bool p1) {
+Task<bool> lookup::ThroneroomEffect(struct stateBlock *state, bool p1) {
     // Plays any action card from your hand twice
     Player *currPlayer = p1 ? state->p1 : state->p2;
-    int idx = DEF_CHOICE;
-    currPlayer->GetHand().PrintPileAsHand();
-    while(idx < 0) {
-        std::cin >> idx;
-        CheckInvalidChoice(currPlayer->HandPtr()->Size(), &idx);
-        if(currPlayer->HandPtr()->At(idx)->GetType() != ACTION &&
-           currPlayer->HandPtr()->At(idx)->GetType() != ATTACK &&
-           currPlayer->HandPtr()->At(idx)->GetType() != REACTION) {
-            idx = DEF_CHOICE;
-            std:: cout << "Selection was not an action card." << std::endl;
-        }
+    int idx = co_await decision::FromHand(*state, p1, DEC_THRONEROOM,
+                                          currPlayer->GetHand(),
+                                          ACTION_CARDS, false);
+    if(idx == DEF_CHOICE) {
+        co_return false;
     }
     bool trashed = false;
+    // The card leaves the hand before it's played, as in the action
+    // phase, so it can't be chosen again by its own effect and the
+    // effect can't move it
+    CardId chosen = currPlayer->HandPtr()->DrawAt(idx);
+    const Card &card = GetCard(chosen);
     // Apply all +action, +buy, +coin, +card and effects twice
     for(int i = 0; i < LIM_THRONEROOM; i++) {
-        if(currPlayer->HandPtr()->At(idx)->GetEffect() != NULL) {
-            trashed = currPlayer->HandPtr()->At(idx)->PlayEffect(state, p1);
+        if(card.GetEffect() != NULL) {
+            trashed = co_await card.PlayEffect(state, p1);
         }
-        currPlayer->AddActions(currPlayer->HandPtr()->At(idx)->GetActions());
-        currPlayer->AddBuys(currPlayer->HandPtr()->At(idx)->GetBuys());
-        int plusCards = currPlayer->HandPtr()->At(idx)->GetCards();
-        for(int i = 0; i < plusCards; i++) {
-            currPlayer->DrawCard();
-        }
-        currPlayer->AddCoins(currPlayer->HandPtr()->At(idx)->GetCoins());
+        currPlayer->AddActions(card.GetActions());
+        currPlayer->AddBuys(card.GetBuys());
+        currPlayer->DrawN(card.GetCards());
+        currPlayer->AddCoins(card.GetCoins());
     }
-    if(trashed) {
-        currPlayer->TrashCard(idx, state->trash);
-    } else {
-        currPlayer->DiscardCard(idx);
-    }
-    return false;
+    game_state::ActionPhaseCleanup(currPlayer, state->trash, chosen,
+                                   trashed);
+    co_return false;
 }
 
-bool lookup::CouncilroomEffect(struct stateBlock *state, bool p1) {
+Task<bool> lookup::CouncilroomEffect(struct stateBlock *state, bool p1) {
     // Other player draws a card
     Player *otherPlayer = p1 ? state->p2 : state->p1;
     otherPlayer->DrawCard();
-    return false;
+    co_return false;
 }
 
-bool lookup::LibraryEffect(struct stateBlock *state, bool p1) {
+Task<bool> lookup::LibraryEffect(struct stateBlock *state, bool p1) {
     // Draw until you have 7 cards in hand. If you draw actions,
     // you may discard them if you wish.
     Player *currPlayer = p1 ? state->p1 : state->p2;
-    while(currPlayer->GetHand().Size() < LIM_LIBRARY) {
-        Card *tmpCard = currPlayer->DeckPtr()->DrawTopCard();
-        if(tmpCard->GetType() == ACTION ||
-           tmpCard->GetType() == ATTACK ||
-           tmpCard->GetType() == REACTION) {
-            std::string cmd;
-            std::cout << tmpCard->ToString() << std::endl;
-            std::cout << "Do you wish to set this card aside? (y/n)"
-                      << std::endl;
-            std::cin >> cmd;
-            if(cmd == "y" || cmd == "yes") {
-                currPlayer->AddToDiscard(tmpCard);
+    Pile *hand = currPlayer->HandPtr();
+    Pile ownSetAside(hand->GetOwner());
+    Pile &setAside = state->setAside != NULL ? *state->setAside
+                                             : ownSetAside;
+    while(hand->Size() < LIM_LIBRARY) {
+        // Draw the whole shortfall at once, then offer the actions drawn
+        size_t drawnFrom = hand->Size();
+        currPlayer->DrawN(LIM_LIBRARY - hand->Size());
+        if(hand->Size() == drawnFrom) {
+            // Deck and discard are both empty
+            break;
+        }
+        size_t i = drawnFrom;
+        while(i < hand->Size()) {
+            if(!GetCard(hand->At(i)).IsAction()) {
+                i++;
+                continue;
+            }
+            if(co_await decision::YesNo(*state, p1, DEC_LIBRARY,
+                                        hand->At(i))) {
+                hand->Move(i, &setAside);
             } else {
-                currPlayer->AddToHand(tmpCard);
+                i++;
             }
-        } else {
-            currPlayer->AddToHand(tmpCard);
         }
     }
-    return false;
+    // Set-aside cards are discarded once the library is done drawing
+    currPlayer->DiscardPtr()->TakeAllFrom(&setAside);
+    co_return false;
 }
 
-bool lookup::MineEffect(struct stateBlock *state, bool p1) {
+Task<bool> lookup::MineEffect(struct stateBlock *state, bool p1) {
     // Trash a treasure card and gain a treasure card costing
     // up to 3 more than it in-hand.
     Player *currPlayer = p1 ? state->p1 : state->p2;
-    std::vector<Pile> *kingdom = state->kingdom;
-    int idx = DEF_CHOICE;
-    while(idx < 0) {;
-        currPlayer->GetHand().PrintPileAsHand();
-        std::cin >> idx;
-        CheckInvalidChoice(currPlayer->HandPtr()->Size(), &idx);
-        if(currPlayer->HandPtr()->At(idx)->GetType() == TREASURE_C) {
-            std::cout << "Card choices:" << std::endl;
-            int cardCost = currPlayer->HandPtr()->At(idx)->GetCost();
-            currPlayer->TrashCard(idx, state->trash);
-            // Treasure cards are the last 3 cards in the kingdom vector
-            // Silver
-            std::cout << "0: " << kingdom->at(IDX_SILVER(kingdom->size()))
-                                  .At(0)->ToString()
-                      << std::endl;
-            // Gold
-            if(cardCost + LIM_MINE >= COST_GOLD) {
-                std::cout << "1: "
-                          << kingdom->at(IDX_GOLD(kingdom->size())).At(0)
-                             ->ToString()
-                          << std::endl;
-            }
-            idx = DEF_CHOICE;
-            while(idx < 0) {
-                std::cin >> idx;
-                CheckInvalidChoice(currPlayer->HandPtr()->Size(), &idx);
-                if(idx >= 0 && idx < LIM_MINE_IDX){
-                    // Add card to hand
-                    currPlayer->AddToHand(kingdom->at(
-                                kingdom->size() - 1 - (1 -idx)).DrawTopCard());
-                } else {
-                    idx = DEF_CHOICE;
-                }
-            }
-        } else {
-            idx = DEF_CHOICE;
-        }
+    int idx = co_await decision::FromHand(*state, p1, DEC_MINE_TRASH,
+                                          currPlayer->GetHand(),
+                                          TREASURE_CARDS, false);
+    if(idx == DEF_CHOICE) {
+        co_return false;
+    }
+    int cardCost = GetCard(currPlayer->GetHand().At(idx)).GetCost();
+    currPlayer->TrashCard(idx, state->trash);
+    idx = co_await decision::FromSupply(*state, p1, DEC_MINE_GAIN,
+                                        CARD_BIT(CARD_SILVER) |
+                                        CARD_BIT(CARD_GOLD),
+                                        cardCost + LIM_MINE, false);
+    if(idx != DEF_CHOICE) {
+        // Add card to hand
+        currPlayer->AddToHand(state->kingdom->Draw(idx));
     }
-    return false;
+    co_return false;
 }
 
-bool lookup::WitchEffect(struct stateBlock *state, bool p1) {
+Task<bool> lookup::WitchEffect(struct stateBlock *state, bool p1) {
     // Opponent gains 1 curse
     Pile *otherDiscard = p1 ? state->p2->DiscardPtr()
                             : state->p1->DiscardPtr();
-    for(size_t i = 0; i < state->kingdom->size(); i++) {
-        if(state->kingdom->at(i).GetName() == "curse") {
-            state->kingdom->at(i).Move(0, otherDiscard);
-        }
+    int curseIdx = state->kingdom->IndexOf(CARD_CURSE);
+    if(curseIdx != CARD_NOT_FOUND) {
+        state->kingdom->Take(curseIdx, otherDiscard);
     }
-    return false;
+    co_return false;
 }
 
-bool lookup::AdventurerEffect(struct stateBlock *state, bool p1) {
+Task<bool> lookup::AdventurerEffect(struct stateBlock *state, bool p1) {
     // Reveal cards from your deck until you find 2 treasures.
     // Put the treasures in-hand and discard the other cards.
     Player *currPlayer = p1 ? state->p1 : state->p2;
+    Pile *hand = currPlayer->HandPtr();
+    Pile ownSetAside(hand->GetOwner());
+    Pile &setAside = state->setAside != NULL ? *state->setAside
+                                             : ownSetAside;
     int treasureCount = 0;
     while(treasureCount < LIM_ADVENTURER) {
-        Card *tmpCard = currPlayer->DeckPtr()->DrawTopCard();
-        if(tmpCard->GetType() == TREASURE_C) {
+        // Drawing reshuffles the discard pile when the deck runs out
+        size_t drawnAt = hand->Size();
+        currPlayer->DrawCard();
+        if(hand->Size() == drawnAt) {
+            // Deck and discard are both empty
+            break;
+        }
+        if(GetCard(hand->At(drawnAt)).GetType() == TREASURE_C) {
             treasureCount++;
-            currPlayer->AddToHand(tmpCard);
         } else {
-            currPlayer->AddToDiscard(tmpCard);
+            hand->Move(drawnAt, &setAside);
+        }
+    }
+    // Revealed cards are discarded once the adventurer is done, so they
+    // can't be reshuffled and revealed again
+    currPlayer->DiscardPtr()->TakeAllFrom(&setAside);
+    co_return false;
+}
+
+constexpr Card lookup::CARD_TABLE[NUM_CARDS] = {
+    // Card(cost, name, type, info, effect,
+    //      +actions, +buys, +cards, +coins, points)
+
+    /* VICTORY CARDS */
+    Card(2, "estate",   VICTORY, "", NULL, 0, 0, 0, 0, 1),
+    Card(5, "duchy",    VICTORY, "", NULL, 0, 0, 0, 0, 3),
+    Card(8, "province", VICTORY, "", NULL, 0, 0, 0, 0, 6),
+    Card(0, "curse",    VICTORY, "", NULL, 0, 0, 0, 0, -1),
+
+    /* TREASURE CARDS */
+    Card(0, "copper", TREASURE_C, "", NULL, 0, 0, 0, 1),
+    Card(3, "silver", TREASURE_C, "", NULL, 0, 0, 0, 2),
+    Card(6, "gold",   TREASURE_C, "", NULL, 0, 0, 0, 3),
+
+    /* KINGDOM CARDS */
+
+    /* COST 2 */
+    Card(2, "cellar", ACTION, CELLAR_INFO, CellarEffect, 1, 0, 0, 0),
+    Card(2, "chapel", ACTION, CHAPEL_INFO, ChapelEffect, 0, 0, 0, 0),
+    Card(2, "moat", REACTION, MOAT_INFO, NULL, 0, 0, 2, 0),
+
+    /* COST 3 */
+    Card(3, "chancellor", ACTION, CHANCELLOR_INFO, ChancellorEffect,
+         0, 0, 0, 3),
+    Card(3, "village", ACTION, "", NULL, 2, 0, 1, 0),
+    Card(3, "woodcutter", ACTION, "", NULL, 0, 1, 0, 2),
+    Card(3, "workshop", ACTION, WORKSHOP_INFO, WorkshopEffect, 0, 0, 0, 0),
+
+    /* COST 4 */
+    Card(4, "bureaucrat", ATTACK, BUREAUCRAT_INFO, BureaucratEffect,
+         0, 0, 0, 0),
+    Card(4, "feast", ACTION, FEAST_INFO, FeastEffect, 0, 0, 0, 0),
+    Card(4, "gardens", VICTORY, GARDENS_INFO, NULL, 0, 0, 0, 0, 0),
+    Card(4, "militia", ATTACK, MILITIA_INFO, MilitiaEffect, 0, 0, 0, 2),
+    Card(4, "moneylender", ACTION, MONEYLENDER_INFO, MoneylenderEffect,
+         0, 0, 0, 0),
+    Card(4, "remodel", ACTION, REMODEL_INFO, RemodelEffect, 0, 0, 0, 0),
+    Card(4, "smithy", ACTION, "", NULL, 0, 0, 3, 0),
+    Card(4, "spy", ATTACK, SPY_INFO, SpyEffect, 1, 0, 1, 0),
+    Card(4, "thief", ATTACK, THIEF_INFO, ThiefEffect, 0, 0, 0, 0),
+    Card(4, "throneroom", ACTION, THRONEROOM_INFO, ThroneroomEffect,
+         0, 0, 0, 0),
+
+    /* COST 5 */
+    Card(5, "councilroom", ACTION, COUNCILROOM_INFO, CouncilroomEffect,
+         0, 1, 4, 0),
+    Card(5, "festival", ACTION, "", NULL, 2, 1, 0, 2),
+    Card(5, "laboratory", ACTION, "", NULL, 1, 0, 2, 0),
+    Card(5, "library", ACTION, LIBRARY_INFO, LibraryEffect, 0, 0, 0, 0),
+    Card(5, "market", ACTION, "", NULL, 1, 1, 1, 1),
+    Card(5, "mine", ACTION, MINE_INFO, MineEffect, 0, 0, 0, 0),
+    Card(5, "witch", ATTACK, WITCH_INFO, WitchEffect, 0, 0, 2, 0),
+
+    /* COST 6 */
+    Card(6, "adventurer", ACTION, ADVENTURER_INFO, AdventurerEffect,
+         0, 0, 0, 0),
+};
+
+namespace {
+    constexpr CardMask KindsWhere(bool (*test)(const Card &card)) {
+        CardMask kinds = 0;
+        for(CardId id = 0; id < NUM_CARDS; id++) {
+            if(test(lookup::CARD_TABLE[id])) {
+                kinds |= CARD_BIT(id);
+            }
+        }
+        return kinds;
+    }
+
+    constexpr bool IsActionCard(const Card &card) {
+        return card.IsAction();
+    }
+
+    constexpr bool IsTreasureCard(const Card &card) {
+        return card.GetType() == TREASURE_C;
+    }
+}
+
+constexpr CardMask lookup::ACTION_CARDS = KindsWhere(IsActionCard);
+constexpr CardMask lookup::TREASURE_CARDS = KindsWhere(IsTreasureCard);
+
+/* Card names are resolved through a perfect hash built at compile time:
+ * seeded FNV-1a over the name, masked to a power-of-two table, with the
+ * seed searched until every card lands in its own slot. */
+namespace {
+    constexpr uint32_t NameHash(const char *name, size_t len, uint32_t seed) {
+        uint32_t hash = 2166136261u ^ seed;
+        for(size_t i = 0; i < len; i++) {
+            hash = (hash ^ (uint8_t)name[i]) * 16777619u;
+        }
+        return (hash ^ (hash >> 16)) & (NAME_HASH_SLOTS - 1);
+    }
+
+    constexpr size_t NameLength(const char *name) {
+        size_t len = 0;
+        while(name[len] != '\0') {
+            len++;
+        }
+        return len;
+    }
+
+    constexpr bool IsPerfectSeed(uint32_t seed) {
+        bool used[NAME_HASH_SLOTS] = {};
+        for(CardId id = 0; id < NUM_CARDS; id++) {
+            const char *name = lookup::CARD_TABLE[id].GetName();
+            uint32_t slot = NameHash(name, NameLength(name), seed);
+            if(used[slot]) {
+                return false;
+            }
+            used[slot] = true;
+        }
+        return true;
+    }
+
+    constexpr uint32_t FindPerfectSeed(void) {
+        uint32_t seed = 0;
+        while(!IsPerfectSeed(seed)) {
+            seed++;
         }
+        return seed;
     }
-    return false;
+
+    struct NameTable {
+        CardId slots[NAME_HASH_SLOTS];
+    };
+
+    constexpr NameTable BuildNameTable(uint32_t seed) {
+        NameTable table = {};
+        for(size_t i = 0; i < NAME_HASH_SLOTS; i++) {
+            table.slots[i] = NO_CARD;
+        }
+        for(CardId id = 0; id < NUM_CARDS; id++) {
+            const char *name = lookup::CARD_TABLE[id].GetName();
+            table.slots[NameHash(name, NameLength(name), seed)] = id;
+        }
+        return table;
+    }
+
+    constexpr uint32_t NAME_SEED = FindPerfectSeed();
+    constexpr NameTable NAME_TABLE = BuildNameTable(NAME_SEED);
 }
 
-std::vector<Card> lookup::GenAllCards(void) {
-    std::vector<Card> allCards;
-
-    allCards.push_back((lookup::cellar));
-    allCards.push_back((lookup::chapel));
-    allCards.push_back((lookup::moat));
-
-    allCards.push_back((lookup::chancellor));
-    allCards.push_back((lookup::village));
-    allCards.push_back((lookup::woodcutter));
-    allCards.push_back((lookup::workshop));
-
-    allCards.push_back((lookup::bureaucrat));
-    allCards.push_back((lookup::feast));
-    allCards.push_back((lookup::gardens));
-    allCards.push_back((lookup::militia));
-    allCards.push_back((lookup::moneylender));
-    allCards.push_back((lookup::remodel));
-    allCards.push_back((lookup::smithy));
-    allCards.push_back((lookup::spy));
-    allCards.push_back((lookup::thief));
-    allCards.push_back((lookup::throneroom));
-
-    allCards.push_back((lookup::councilroom));
-    allCards.push_back((lookup::festival));
-    allCards.push_back((lookup::laboratory));
-    allCards.push_back((lookup::library));
-    allCards.push_back((lookup::market));
-    allCards.push_back((lookup::mine));
-    allCards.push_back((lookup::witch));
-
-    allCards.push_back((lookup::adventurer));
+CardId lookup::FindCard(std::string_view name) {
+    CardId id = NAME_TABLE.slots[NameHash(name.data(), name.size(),
+                                          NAME_SEED)];
+    // One compare rejects anything that isn't a card name
+    if(id != NO_CARD && name == CARD_TABLE[id].GetName()) {
+        return id;
+    }
+    return NO_CARD;
+}
 
+std::vector<CardId> lookup::GenAllCards(void) {
+    std::vector<CardId> allCards;
+    for(CardId id = CARD_CELLAR; id < NUM_CARDS; id++) {
+        allCards.push_back(id);
+    }
     return allCards;
 }
@@ -4,21 +4,20 @@
  * Contains declarations for card effects,
  * utilities for handling i/o errors in card
  * effects, and a function to generate a vector
- * of all action cards. Also defines const
- * Cards that are used in numerous places as
- * the basis for all cards.
+ * of all action cards. Also declares the
+ * card table that every CardId indexes into.
  */
 
 #ifndef __CARDLOOKUP_H__
 #define __CARDLOOKUP_H__
 
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "Card.h"
-#include "ActionCard.h"
-#include "TreasureCard.h"
-#include "VictoryCard.h"
 #include "Pile.h"
+#include "Task.h"
 #include "InfoStrings.h"
 
 // Input defaults
@@ -37,15 +36,12 @@
 #define LIM_MINE_IDX   2
 #define LIM_ADVENTURER 2
 
-// Card indices
-#define IDX_SILVER(size) size - 2
-#define IDX_GOLD(size)   size - 1
-
 // Coins granted by card effects
 #define COINS_MONEYLENDER 3
 
-// Card costs
-#define COST_GOLD 6
+// Slots in the card-name hash table; a power of two, and roomy enough
+// that a collision-free seed turns up after a few tries
+#define NAME_HASH_SLOTS 128
 
 // Command strings
 #define YES "y"
@@ -56,101 +52,42 @@ namespace lookup {
     void CheckInvalidChoice(size_t pileSize, int *choicePtr);
 
     /* ACTION EFFECTS */
-    bool CellarEffect(struct stateBlock *state, bool p1);
-    bool ChapelEffect(struct stateBlock *state, bool p1);
-    bool ChancellorEffect(struct stateBlock *state, bool p1);
-    bool WorkshopEffect(struct stateBlock *state, bool p1);
-    bool BureaucratEffect(struct stateBlock *state, bool p1);
-    bool FeastEffect(struct stateBlock *state, bool p1);
-    bool MilitiaEffect(struct stateBlock *state, bool p1);
-    bool MoneylenderEffect(struct stateBlock *state, bool p1);
-    bool RemodelEffect(struct stateBlock *state, bool p1);
-    bool SpyEffect(struct stateBlock *state, bool p1);
-    bool ThiefEffect(struct stateBlock *state, bool p1);
-    bool ThroneroomEffect(struct stateBlock *state, bool p1);
-    bool CouncilroomEffect(struct stateBlock *state, bool p1);
-    bool LibraryEffect(struct stateBlock *state, bool p1);
-    bool MineEffect(struct stateBlock *state, bool p1);
-    bool WitchEffect(struct stateBlock *state, bool p1);
-    bool AdventurerEffect(struct stateBlock *state, bool p1);
-
-    /* VICTORY CARDS */
-    const VictoryCard estate   = VictoryCard(2, 1, "estate", VICTORY);
-    const VictoryCard duchy    = VictoryCard(5, 3, "duchy", VICTORY);
-    const VictoryCard province = VictoryCard(8, 6, "province", VICTORY);
-    const VictoryCard curse    = VictoryCard(0, -1, "curse", VICTORY);
-
-    /* TREASURE CARDS */
-    const TreasureCard copper  = TreasureCard(0, 1, "copper", TREASURE_C);
-    const TreasureCard silver  = TreasureCard(3, 2, "silver", TREASURE_C);
-    const TreasureCard gold    = TreasureCard(6, 3, "gold", TREASURE_C);
-
-    /* KINGDOM CARDS */
-
-    /* COST 2 */
-    const ActionCard cellar    = ActionCard(2,1,0,0,0,"cellar",
-                                 CellarEffect, ACTION, CELLAR_INFO);
-    const ActionCard chapel    = ActionCard(2,0,0,0,0,"chapel",
-                                 ChapelEffect, ACTION, CHAPEL_INFO);
-    const ActionCard moat      = ActionCard(2,0,0,2,0,"moat",
-                                  NULL, REACTION, MOAT_INFO);
-
-    /* COST 3 */
-    const ActionCard chancellor = ActionCard(3,0,0,0,3,"chancellor",
-                                  ChancellorEffect, ACTION, CHANCELLOR_INFO);
-    const ActionCard village = ActionCard(3,2,0,1,0,"village",
-                                  NULL, ACTION);
-    const ActionCard woodcutter = ActionCard(3,0,1,0,2,"woodcutter",
-                                  NULL, ACTION);
-    const ActionCard workshop = ActionCard(3,0,0,0,0,"workshop",
-                                  WorkshopEffect, ACTION, WORKSHOP_INFO);
-
-    /* COST 4 */
-    const ActionCard bureaucrat = ActionCard(4,0,0,0,0,"bureaucrat",
-                                  BureaucratEffect, ATTACK, BUREAUCRAT_INFO);
-    const ActionCard feast = ActionCard(4,0,0,0,0,"feast",
-                                  FeastEffect, ACTION, FEAST_INFO);
-    const VictoryCard gardens = VictoryCard(4,0,"gardens", VICTORY,
-                                            GARDENS_INFO);
-    const ActionCard militia = ActionCard(4,0,0,0,2,"militia",
-                                  MilitiaEffect, ATTACK, MILITIA_INFO);
-    const ActionCard moneylender = ActionCard(4,0,0,0,0,"moneylender",
-                                  MoneylenderEffect, ACTION, MONEYLENDER_INFO);
-    const ActionCard remodel = ActionCard(4,0,0,0,0,"remodel",
-                                  RemodelEffect, ACTION, REMODEL_INFO);
-    const ActionCard smithy = ActionCard(4,0,0,3,0,"smithy",
-                                  NULL, ACTION);
-    const ActionCard spy = ActionCard(4,1,0,1,0,"spy",
-                                  SpyEffect, ATTACK, SPY_INFO);
-    const ActionCard thief = ActionCard(4,0,0,0,0,"thief",
-                                  ThiefEffect, ATTACK, THIEF_INFO);
-    const ActionCard throneroom = ActionCard(4,0,0,0,0,"throneroom",
-                                  ThroneroomEffect, ACTION, THRONEROOM_INFO);
-
-    /* COST 5 */
-    const ActionCard councilroom = ActionCard(5,0,1,4,0,"councilroom",
-                                  CouncilroomEffect, ACTION, COUNCILROOM_INFO);
-    const ActionCard festival = ActionCard(5,2,1,0,2,"festival",
-                                    NULL, ACTION);
-    const ActionCard laboratory = ActionCard(5,1,0,2,0,"laboratory",
-                                    NULL, ACTION);
-    const ActionCard library = ActionCard(5,0,0,0,0,"library",
-                                  LibraryEffect, ACTION, LIBRARY_INFO);
-    const ActionCard market = ActionCard(5,1,1,1,1,"market", NULL, ACTION);
-    const ActionCard mine = ActionCard(5,0,0,0,0,"mine",
-                                  MineEffect, ACTION, MINE_INFO);
-    const ActionCard witch = ActionCard(5,0,0,2,0,"witch",
-                                  WitchEffect, ATTACK, WITCH_INFO);
-
-    /* COST 6 */
-    const ActionCard adventurer = ActionCard(6,0,0,0,0,"adventurer",
-                                  AdventurerEffect, ACTION, ADVENTURER_INFO);
-
-    /* DUMMY */
-    const Card dummy = Card(DEF_COST, DEF_NAME);
-
-    /* VECTOR OF ALL CARDS */
-    std::vector<Card> GenAllCards(void);
+    // Each returns whether the card trashed itself, awaiting every choice
+    // it asks for
+    Task<bool> CellarEffect(struct stateBlock *state, bool p1);
+    Task<bool> ChapelEffect(struct stateBlock *state, bool p1);
+    Task<bool> ChancellorEffect(struct stateBlock *state, bool p1);
+    Task<bool> WorkshopEffect(struct stateBlock *state, bool p1);
+    Task<bool> BureaucratEffect(struct stateBlock *state, bool p1);
+    Task<bool> FeastEffect(struct stateBlock *state, bool p1);
+    Task<bool> MilitiaEffect(struct stateBlock *state, bool p1);
+    Task<bool> MoneylenderEffect(struct stateBlock *state, bool p1);
+    Task<bool> RemodelEffect(struct stateBlock *state, bool p1);
+    Task<bool> SpyEffect(struct stateBlock *state, bool p1);
+    Task<bool> ThiefEffect(struct stateBlock *state, bool p1);
+    Task<bool> ThroneroomEffect(struct stateBlock *state, bool p1);
+    Task<bool> CouncilroomEffect(struct stateBlock *state, bool p1);
+    Task<bool> LibraryEffect(struct stateBlock *state, bool p1);
+    Task<bool> MineEffect(struct stateBlock *state, bool p1);
+    Task<bool> WitchEffect(struct stateBlock *state, bool p1);
+    Task<bool> AdventurerEffect(struct stateBlock *state, bool p1);
+
+    /* CARD TABLE */
+    // One immutable entry per CardId, in CardId order
+    extern const Card CARD_TABLE[NUM_CARDS];
+
+    // Returns the table entry for `id`
+    inline const Card &GetCard(CardId id) { return CARD_TABLE[id]; }
+
+    // Every action (including attacks and reactions) and every treasure
+    extern const CardMask ACTION_CARDS;
+    extern const CardMask TREASURE_CARDS;
+
+    /* VECTOR OF ALL KINGDOM CARDS */
+    std::vector<CardId> GenAllCards(void);
+    // Returns the card called `name`, or NO_CARD if there isn't one.
+    // Hashes the name once and compares it once; never allocates.
+    CardId FindCard(std::string_view name);
 
 }
 
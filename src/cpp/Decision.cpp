@@ -0,0 +1,853 @@
+/* DOMINION
+ * David Mally, Richard Roberts
+ * Decision.cpp
+ * Defines the stdin/stdout and in-process decision providers, and the
+ * checked entry points the engine calls to ask them.
+ */
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <coroutine>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+
+#include "Decision.h"
+#include "CardLookup.h"
+#include "GameState.h"
+
+namespace {
+    // Returns the phase a question comes up in, for resending the GSV
+    std::string PhaseOf(Decision type) {
+        switch(type) {
+            case DEC_PLAY_TREASURE:
+                return "treasure";
+            case DEC_BUY:
+                return "buy";
+            default:
+                return "action";
+        }
+    }
+
+    // Whether the stdin player's answer has been cut off, by their clock
+    // or by input running out; StdinDecider stops asking again once it has
+    bool CutOff(void) {
+        return decision::Input().TimedOut() || decision::Input().AtEnd();
+    }
+
+    // Reads the next word, first answering any STATE_CMD or RESYNC_CMD
+    // before it. Returns "" once input has run out.
+    std::string_view ReadToken(const struct stateBlock &state, bool p1,
+                               Decision type) {
+        InputReader &in = decision::Input();
+        std::string_view token;
+        while(!(token = in.NextToken()).empty()) {
+            if(token == STATE_CMD) {
+                game_state::SendGSV(state, p1, PhaseOf(type));
+            } else if(token == RESYNC_CMD) {
+                game_state::ResendGSV(state, p1, PhaseOf(type));
+            } else {
+                return token;
+            }
+        }
+        return token;
+    }
+
+    // Reads a number and checks it is -1 or an index below `size`;
+    // returns BAD_CHOICE (after saying so) when it isn't
+    int ReadIndex(const struct stateBlock &state, bool p1, Decision type,
+                  size_t size) {
+        long choice;
+        if(!InputReader::ParseInt(ReadToken(state, p1, type), &choice) ||
+           choice < DEF_CHOICE || choice >= (long)size) {
+            if(!CutOff()) {
+                game_state::Out() << "Invalid choice." << std::endl;
+            }
+            return BAD_CHOICE;
+        }
+        return choice;
+    }
+
+    // Reads one line of distinct indices below `size` into `picks`; a -1
+    // ends the set early. Returns false (after saying so) if any of them
+    // isn't one.
+    bool ReadIndexSet(const struct stateBlock &state, bool p1, Decision type,
+                      size_t size, std::vector<int> *picks) {
+        InputReader &in = decision::Input();
+        bool valid = true;
+        bool done = false;
+        do {
+            long choice;
+            std::string_view token = ReadToken(state, p1, type);
+            if(done || token.empty()) {
+                // Ignore whatever follows a -1
+            } else if(!InputReader::ParseInt(token, &choice) ||
+                      choice < DEF_CHOICE || choice >= (long)size ||
+                      std::find(picks->begin(), picks->end(),
+                                choice) != picks->end()) {
+                valid = false;
+            } else if(choice == DEF_CHOICE) {
+                done = true;
+            } else {
+                picks->push_back(choice);
+            }
+        } while(!in.EndOfLine());
+        if(!valid) {
+            game_state::Out() << "Invalid choice." << std::endl;
+        }
+        return valid;
+    }
+
+    // Reads a card name; returns DEF_CHOICE for "-1", else the card
+    int ReadName(const struct stateBlock &state, bool p1, Decision type,
+                 CardId *card) {
+        std::string_view name = ReadToken(state, p1, type);
+        if(name == "-1") {
+            return DEF_CHOICE;
+        }
+        *card = lookup::FindCard(name);
+        return 0;
+    }
+
+    thread_local InputReader *inSource = NULL;
+
+    // Lists every option in CardId order as "pile: card"
+    void PrintSupplyOptions(const Supply &kingdom, CardMask options) {
+        if(game_state::IsHeadless()) {
+            return;
+        }
+        std::ostream &out = game_state::Out();
+        for(CardId card = 0; card < NUM_CARDS; card++) {
+            if(options & CARD_BIT(card)) {
+                out << kingdom.IndexOf(card) << ": "
+                    << lookup::GetCard(card).ToString() << std::endl;
+            }
+        }
+    }
+
+    bool InMask(CardMask options, CardId card) {
+        return card < NUM_CARDS && (options & CARD_BIT(card));
+    }
+
+    // Whether `legal` holds exactly one kind of card
+    bool OneKind(CardMask legal) {
+        return legal != 0 && (legal & (legal - 1)) == 0;
+    }
+
+    // Answers for FALLBACK_PASS: declines everything, and leaves the
+    // wrappers to make any pick that can't be declined
+    class PassDecider : public BotDecider {
+        public:
+            int ChooseFromHand(const struct stateBlock &, bool, Decision,
+                               const Pile &, CardMask, bool) {
+                return DEF_CHOICE;
+            }
+            void ChooseManyFromHand(const struct stateBlock &, bool,
+                                    Decision, const Pile &, CardMask, int,
+                                    int, std::vector<int> *) {}
+            int ChooseFromSupply(const struct stateBlock &, bool, Decision,
+                                 CardMask, int, bool) {
+                return DEF_CHOICE;
+            }
+    };
+
+    // Answers for FALLBACK_HEURISTIC: what BotDecider would, except that
+    // it ends the action phase instead of playing an action, whose effect
+    // would only ask more of a player who is out of time
+    class FallbackDecider : public BotDecider {
+        public:
+            int ChooseFromHand(const struct stateBlock &state, bool p1,
+                               Decision type, const Pile &hand,
+                               CardMask options, bool canDecline) {
+                if(type == DEC_PLAY_ACTION) {
+                    return DEF_CHOICE;
+                }
+                return BotDecider::ChooseFromHand(state, p1, type, hand,
+                                                  options, canDecline);
+            }
+    };
+
+    // Answers for FALLBACK_FIRST_LEGAL: the first legal card in the hand
+    // or the supply, and as few cards as allowed, but no action played
+    class FirstLegalDecider : public FallbackDecider {
+        public:
+            int ChooseFromSupply(const struct stateBlock &state, bool,
+                                 Decision, CardMask options, int, bool) {
+                for(size_t i = 0; i < state.kingdom->Size(); i++) {
+                    if(InMask(options, state.kingdom->At(i).GetTopCard())) {
+                        return i;
+                    }
+                }
+                return DEF_CHOICE;
+            }
+    };
+
+    // Suspends the game until `provider` has its answer
+    struct Parked {
+        DecisionProvider *provider;
+        bool await_ready(void) { return false; }
+        void await_suspend(std::coroutine_handle<> game) {
+            provider->Park(game);
+        }
+        void await_resume(void) {}
+    };
+
+    // Calls `ask` to put a question to `provider`, and again each time
+    // the game is resumed, until the answer isn't Pending
+    template <typename Ask>
+    Task<> Answered(DecisionProvider *provider, Ask ask) {
+        ask();
+        while(provider->Pending()) {
+            co_await Parked{provider};
+            ask();
+        }
+    }
+
+    PlayerClock *ClockOf(const struct stateBlock &state, bool p1) {
+        PlayerClock *clock = p1 ? state.p1Clock : state.p2Clock;
+        return clock != NULL && clock->IsSet() ? clock : NULL;
+    }
+
+    // Starts the player's clock, if they have one, before they're asked.
+    // A stdin player is told their budget, unless they've already
+    // answered, and their reader gives up at the deadline.
+    void StartClock(const struct stateBlock &state, bool p1) {
+        PlayerClock *clock = ClockOf(state, p1);
+        if(clock == NULL) {
+            return;
+        }
+        auto deadline = clock->Start();
+        if(decision::IsStdin(state, p1)) {
+            InputReader &in = decision::Input();
+            if(!in.HasQueued()) {
+                auto moveMs = std::chrono::ceil<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now());
+                std::cout << CLOCK_HEADER
+                          << std::max<int64_t>(moveMs.count(), 0) << " "
+                          << clock->GameLeftMs() << std::endl;
+            }
+            in.SetDeadline(deadline);
+        }
+    }
+
+    // Stops the player's clock once they've answered. Returns the
+    // provider to answer instead if they ran out of time, else NULL.
+    DecisionProvider *StopClock(const struct stateBlock &state, bool p1) {
+        static PassDecider passDecider;
+        static FirstLegalDecider firstLegalDecider;
+        static FallbackDecider heuristicDecider;
+        PlayerClock *clock = ClockOf(state, p1);
+        if(clock == NULL) {
+            return NULL;
+        }
+        bool stdinPlayer = decision::IsStdin(state, p1);
+        bool cutOff = false;
+        if(stdinPlayer) {
+            cutOff = decision::Input().TimedOut();
+            decision::Input().ClearDeadline();
+        }
+        if(!clock->Stop(cutOff)) {
+            return NULL;
+        }
+        if(stdinPlayer) {
+            std::cout << TIMEOUT_LINE << std::endl;
+        }
+        switch(clock->GetFallback()) {
+            case FALLBACK_PASS:
+                return &passDecider;
+            case FALLBACK_FIRST_LEGAL:
+                return &firstLegalDecider;
+            default:
+                return &heuristicDecider;
+        }
+    }
+}
+
+PlayerClock::PlayerClock(void)
+    : m_moveMs(0), m_gameMs(0), m_fallback(FALLBACK_HEURISTIC),
+      m_usedMs(0), m_timeouts(0) {}
+
+void PlayerClock::Set(int64_t moveMs, int64_t gameMs, Fallback fallback) {
+    m_moveMs = moveMs;
+    m_gameMs = gameMs;
+    m_fallback = fallback;
+}
+
+bool PlayerClock::IsSet(void) const {
+    return m_moveMs > 0 || m_gameMs > 0;
+}
+
+void PlayerClock::Reset(void) {
+    m_usedMs = 0;
+    m_timeouts = 0;
+}
+
+std::chrono::steady_clock::time_point PlayerClock::Start(void) {
+    m_start = std::chrono::steady_clock::now();
+    int64_t allowed = m_gameMs > 0 ? GameLeftMs() : m_moveMs;
+    if(m_moveMs > 0) {
+        allowed = std::min(allowed, m_moveMs);
+    }
+    m_deadline = m_start + std::chrono::milliseconds(allowed);
+    return m_deadline;
+}
+
+bool PlayerClock::Stop(bool cutOff) {
+    auto now = std::chrono::steady_clock::now();
+    m_usedMs += std::chrono::duration_cast<std::chrono::milliseconds>(
+        now - m_start).count();
+    if(cutOff || now > m_deadline) {
+        m_timeouts++;
+        return true;
+    }
+    return false;
+}
+
+int64_t PlayerClock::GameLeftMs(void) const {
+    if(m_gameMs <= 0) {
+        return -1;
+    }
+    return std::max<int64_t>(m_gameMs - m_usedMs, 0);
+}
+
+Fallback PlayerClock::GetFallback(void) const {
+    return m_fallback;
+}
+
+int64_t PlayerClock::GetUsedMs(void) const {
+    return m_usedMs;
+}
+
+int PlayerClock::GetTimeouts(void) const {
+    return m_timeouts;
+}
+
+int StdinDecider::ChooseFromHand(const struct stateBlock &state, bool p1,
+                                 Decision type, const Pile &hand,
+                                 CardMask options, bool canDecline) {
+    std::ostream &out = game_state::Out();
+    Player *player = p1 ? state.p1 : state.p2;
+    int idx = BAD_CHOICE;
+    switch(type) {
+        case DEC_PLAY_ACTION:
+        case DEC_PLAY_TREASURE:
+            // Cards are named, not numbered, in the play phases
+            while(idx == BAD_CHOICE && !CutOff()) {
+                if(type == DEC_PLAY_ACTION) {
+                    out << "You have " << player->GetActions()
+                        << " action(s) remaining." << std::endl;
+                    hand.PrintPileAsHand();
+                    if(!decision::Input().HasQueued()) {
+                        std::cout << "response?" << std::endl;
+                    }
+                } else {
+                    out << "You have " << player->GetCoins()
+                        << " coins(s)." << std::endl;
+                    out << "Hand:" << std::endl;
+                    // Nobody reads the card blocks when headless
+                    for(size_t i = 0; !game_state::IsHeadless() &&
+                        i < hand.Size(); i++) {
+                        const Card &card = lookup::GetCard(hand.At(i));
+                        game_state::SetColorByType(card.GetType());
+                        out << i << ": " << card.ToString()
+                            << std::endl;
+                    }
+                    if(!decision::Input().HasQueued()) {
+                        std::cout << "response?" << std::endl;
+                    }
+                    game_state::ResetColor();
+                }
+                CardId card = NO_CARD;
+                if(ReadName(state, p1, type, &card) == DEF_CHOICE) {
+                    idx = DEF_CHOICE;
+                } else if(InMask(options, card)) {
+                    idx = hand.LookThrough(card);
+                    if(idx == CARD_NOT_FOUND) {
+                        idx = BAD_CHOICE;
+                    }
+                }
+            }
+            return idx;
+        case DEC_MINE_TRASH:
+            // Reprints the hand on every attempt
+            while(idx < 0 && !CutOff()) {
+                hand.PrintPileAsHand();
+                idx = ReadIndex(state, p1, type, hand.Size());
+                if(idx >= 0 && !InMask(options, hand.At(idx))) {
+                    idx = BAD_CHOICE;
+                }
+            }
+            return idx;
+        default:
+            hand.PrintPileAsHand();
+            while(idx == BAD_CHOICE && !CutOff()) {
+                idx = ReadIndex(state, p1, type, hand.Size());
+                if(idx == DEF_CHOICE && !canDecline) {
+                    idx = BAD_CHOICE;
+                } else if(idx >= 0 && !InMask(options, hand.At(idx))) {
+                    idx = BAD_CHOICE;
+                    if(type == DEC_THRONEROOM) {
+                        out << "Selection was not an action card."
+                            << std::endl;
+                    }
+                }
+            }
+            return idx;
+    }
+}
+
+void StdinDecider::ChooseManyFromHand(const struct stateBlock &state,
+                                      bool p1, Decision type,
+                                      const Pile &hand, CardMask options,
+                                      int min, int max,
+                                      std::vector<int> *picks) {
+    std::ostream &out = game_state::Out();
+    // The hand is shown once and the whole choice is one line of its
+    // indices, so it takes one answer however many cards it names
+    if(type == DEC_MILITIA) {
+        out << "Choose card(s) to discard:" << std::endl;
+    }
+    hand.PrintPileAsHand();
+    while(!CutOff()) {
+        if(type == DEC_CELLAR) {
+            out << "Choose cards to discard (0 - " << hand.Size() - 1
+                << ", separated by spaces) or -1 to discard none:"
+                << std::endl;
+        } else if(type == DEC_CHAPEL) {
+            out << "Choose up to " << max << " cards to trash (0 - "
+                << hand.Size() - 1
+                << ", separated by spaces) or -1 to trash none:"
+                << std::endl;
+        } else if(min == max) {
+            out << "Choose " << min << " card(s) (0 - " << hand.Size() - 1
+                << ", separated by spaces):" << std::endl;
+        } else {
+            out << "Choose " << min << " to " << max << " card(s) (0 - "
+                << hand.Size() - 1 << ", separated by spaces):"
+                << std::endl;
+        }
+        if(!decision::Input().HasQueued()) {
+            std::cout << PICK_HEADER << type << " " << min << " " << max;
+            for(size_t i = 0; i < hand.Size(); i++) {
+                std::cout << " " << lookup::GetCard(hand.At(i)).GetName();
+            }
+            std::cout << std::endl << "response?" << std::endl;
+        }
+        picks->clear();
+        if(!ReadIndexSet(state, p1, type, hand.Size(), picks)) {
+            continue;
+        }
+        bool legal = (int)picks->size() >= min && (int)picks->size() <= max;
+        for(int idx : *picks) {
+            legal = legal && InMask(options, hand.At(idx));
+        }
+        if(legal || CutOff()) {
+            return;
+        }
+        out << "Invalid choice." << std::endl;
+    }
+}
+
+int StdinDecider::ChooseFromSupply(const struct stateBlock &state, bool p1,
+                                   Decision type, CardMask options,
+                                   int maxCost, bool canDecline) {
+    std::ostream &out = game_state::Out();
+    Player *player = p1 ? state.p1 : state.p2;
+    const Supply &kingdom = *state.kingdom;
+    int idx = BAD_CHOICE;
+    CardId card = NO_CARD;
+    switch(type) {
+        case DEC_BUY:
+            while(idx == BAD_CHOICE && !CutOff()) {
+                out << "Buyable cards:" << std::endl;
+                for(size_t i = 0; !game_state::IsHeadless() &&
+                    i < kingdom.Size(); i++) {
+                    const Card &pileCard =
+                        lookup::GetCard(kingdom.At(i).GetTopCard());
+                    game_state::SetColorByType(pileCard.GetType());
+                    out << "Card " << i << ": "
+                        << pileCard.ToString()
+                        << "   ";
+                    if((i+1) % 5 == 0) {
+                        out << std::endl;
+                    }
+                }
+                game_state::ResetColor();
+                out << "\nYou have " << player->GetCoins()
+                    << " coins(s) and " << player->GetBuys()
+                    << " buy(s) remaining." << std::endl;
+                out << "Type a card's number to buy it." << std::endl;
+                if(ReadName(state, p1, type, &card) == DEF_CHOICE) {
+                    return DEF_CHOICE;
+                }
+                idx = kingdom.IndexOf(card);
+                if(idx == CARD_NOT_FOUND) {
+                    idx = BAD_CHOICE;
+                } else if(kingdom.At(idx).Size() == 0) {
+                    out << "That pile is empty!" << std::endl;
+                    idx = BAD_CHOICE;
+                } else if(!InMask(options, card)) {
+                    out << "You don't have enough coins to buy that!"
+                        << std::endl;
+                    idx = BAD_CHOICE;
+                }
+            }
+            return idx;
+        case DEC_WORKSHOP:
+            out << "Choose a card with cost <= $" << maxCost << ":"
+                << std::endl;
+            for(CardId option = 0; option < NUM_CARDS; option++) {
+                if(options & CARD_BIT(option)) {
+                    out << lookup::GetCard(option).GetName()
+                        << std::endl;
+                }
+            }
+            while(!InMask(options, card) && !CutOff()) {
+                out << "Name a card: ";
+                if(ReadName(state, p1, type, &card) == DEF_CHOICE &&
+                   canDecline) {
+                    return DEF_CHOICE;
+                }
+            }
+            return kingdom.IndexOf(card);
+        case DEC_FEAST:
+            out << "Gain a card costing up to $" << maxCost << ":"
+                << std::endl;
+            PrintSupplyOptions(kingdom, options);
+            while(idx < 0 && !CutOff()) {
+                idx = ReadIndex(state, p1, type, kingdom.Size());
+                if(idx < 0) {
+                    continue;
+                } else if(lookup::GetCard(kingdom.At(idx).GetTopCard())
+                          .GetCost() > maxCost) {
+                    out << "Invalid choice. Card must cost <= $"
+                        << maxCost << "." << std::endl;
+                    idx = DEF_CHOICE;
+                } else if(kingdom.At(idx).Size() == 0) {
+                    out << "Invalid choice. That pile is empty."
+                        << std::endl;
+                    idx = DEF_CHOICE;
+                } else if(!InMask(options, kingdom.At(idx).GetTopCard())) {
+                    idx = DEF_CHOICE;
+                }
+            }
+            return idx;
+        case DEC_MINE_GAIN:
+            // Choice 0 is silver, choice 1 is gold
+            out << "Card choices:" << std::endl;
+            for(CardId option = CARD_SILVER; option <= CARD_GOLD; option++) {
+                if(options & CARD_BIT(option)) {
+                    out << option - CARD_SILVER << ": "
+                        << lookup::GetCard(option).ToString()
+                        << std::endl;
+                }
+            }
+            while(!InMask(options, card) && !CutOff()) {
+                idx = ReadIndex(state, p1, type, LIM_MINE_IDX);
+                card = idx >= 0 ? (CardId)(CARD_SILVER + idx) : NO_CARD;
+            }
+            return kingdom.IndexOf(card);
+        default:
+            PrintSupplyOptions(kingdom, options);
+            while(idx < 0 && !CutOff()) {
+                out << "Choose a card from the kingdom costing up to $"
+                    << maxCost << ":" << std::endl;
+                idx = ReadIndex(state, p1, type, kingdom.Size());
+                if(idx == DEF_CHOICE && canDecline) {
+                    return DEF_CHOICE;
+                }
+                if(idx >= 0 && !InMask(options, kingdom.At(idx).GetTopCard())) {
+                    idx = DEF_CHOICE;
+                }
+            }
+            return idx;
+    }
+}
+
+bool StdinDecider::ChooseYesNo(const struct stateBlock &state, bool p1,
+                               Decision type, CardId card) {
+    std::ostream &out = game_state::Out();
+    switch(type) {
+        case DEC_CHANCELLOR:
+            out << "Put deck -> discard? (y/n) ";
+            break;
+        case DEC_MONEYLENDER:
+            out << "Trash a copper and gain $3? (y/n)" << std::endl;
+            break;
+        case DEC_SPY_SELF:
+            out << std::endl << "Discard your card? (y/n)" << std::endl;
+            break;
+        case DEC_SPY_OTHER:
+            out << std::endl << "Discard your opponent's card? (y/n)"
+                << std::endl;
+            break;
+        case DEC_THIEF_GAIN:
+            out << "Do you wish to gain the trashed card? (y/n)"
+                << std::endl;
+            break;
+        case DEC_LIBRARY:
+            out << lookup::GetCard(card).ToString() << std::endl;
+            out << "Do you wish to set this card aside? (y/n)"
+                << std::endl;
+            break;
+        default:
+            out << "Trash " << lookup::GetCard(card).GetName()
+                << "? (y/n)" << std::endl;
+            break;
+    }
+    std::string_view cmd = ReadToken(state, p1, type);
+    return cmd == YES || cmd == "yes";
+}
+
+int BotDecider::ChooseFromHand(const struct stateBlock &, bool, Decision,
+                               const Pile &hand, CardMask options, bool) {
+    for(size_t i = 0; i < hand.Size(); i++) {
+        if(InMask(options, hand.At(i))) {
+            return i;
+        }
+    }
+    return DEF_CHOICE;
+}
+
+void BotDecider::ChooseManyFromHand(const struct stateBlock &, bool,
+                                    Decision, const Pile &hand,
+                                    CardMask options, int min, int,
+                                    std::vector<int> *picks) {
+    for(size_t i = 0; i < hand.Size() && (int)picks->size() < min; i++) {
+        if(InMask(options, hand.At(i))) {
+            picks->push_back(i);
+        }
+    }
+}
+
+int BotDecider::ChooseFromSupply(const struct stateBlock &state, bool,
+                                 Decision, CardMask options, int,
+                                 bool canDecline) {
+    // Never volunteers for a curse
+    if(canDecline) {
+        options &= ~CARD_BIT(CARD_CURSE);
+    }
+    int best = DEF_CHOICE;
+    int bestCost = DEF_COST;
+    for(size_t i = 0; i < state.kingdom->Size(); i++) {
+        CardId card = state.kingdom->At(i).GetTopCard();
+        if(InMask(options, card) &&
+           lookup::GetCard(card).GetCost() > bestCost) {
+            best = i;
+            bestCost = lookup::GetCard(card).GetCost();
+        }
+    }
+    return best;
+}
+
+bool BotDecider::ChooseYesNo(const struct stateBlock &, bool, Decision,
+                             CardId) {
+    return false;
+}
+
+DecisionProvider *decision::For(const struct stateBlock &state, bool p1) {
+    static StdinDecider stdinDecider;
+    // Plays on for a stdin player whose input has ended, so the game
+    // still finishes; declining everything would never end it
+    static BotDecider endedDecider;
+    DecisionProvider *provider = p1 ? state.p1Decider : state.p2Decider;
+    if(provider != NULL) {
+        return provider;
+    }
+    if(Input().AtEnd()) {
+        return &endedDecider;
+    }
+    return &stdinDecider;
+}
+
+bool decision::WantsPrompt(const struct stateBlock &state, bool p1) {
+    return IsStdin(state, p1) && !Input().HasQueued();
+}
+
+void decision::SetInput(InputReader *reader) {
+    inSource = reader;
+}
+
+InputReader &decision::Input(void) {
+    static InputReader stdinReader(STDIN_FILENO);
+    return inSource != NULL ? *inSource : stdinReader;
+}
+
+bool decision::IsStdin(const struct stateBlock &state, bool p1) {
+    DecisionProvider *provider = For(state, p1);
+    return dynamic_cast<StdinDecider *>(provider) != NULL;
+}
+
+CardMask decision::KindsIn(const Pile &pile, CardMask options) {
+    CardMask kinds = 0;
+    for(CardId card = 0; card < NUM_CARDS; card++) {
+        if((options & CARD_BIT(card)) && pile.Contains(card)) {
+            kinds |= CARD_BIT(card);
+        }
+    }
+    return kinds;
+}
+
+Task<int> decision::FromHand(const struct stateBlock &state, bool p1,
+                             Decision type, const Pile &hand,
+                             CardMask options, bool canDecline) {
+    CardMask legal = KindsIn(hand, options);
+    if(legal == 0) {
+        if(!canDecline || state.autoResolve) {
+            co_return DEF_CHOICE;
+        }
+    } else if(state.autoResolve && !canDecline && OneKind(legal)) {
+        for(size_t i = 0; i < hand.Size(); i++) {
+            if(InMask(legal, hand.At(i))) {
+                co_return i;
+            }
+        }
+    }
+    DecisionProvider *provider = For(state, p1);
+    int idx = DEF_CHOICE;
+    StartClock(state, p1);
+    co_await Answered(provider, [&] {
+        idx = provider->ChooseFromHand(state, p1, type, hand, legal,
+                                       canDecline);
+    });
+    if((provider = StopClock(state, p1)) != NULL) {
+        idx = provider->ChooseFromHand(state, p1, type, hand, legal,
+                                       canDecline);
+    }
+    if(idx >= 0 && idx < (int)hand.Size() && InMask(legal, hand.At(idx))) {
+        co_return idx;
+    }
+    if(canDecline) {
+        co_return DEF_CHOICE;
+    }
+    for(size_t i = 0; i < hand.Size(); i++) {
+        if(InMask(legal, hand.At(i))) {
+            co_return i;
+        }
+    }
+    co_return DEF_CHOICE;
+}
+
+Task<> decision::ManyFromHand(const struct stateBlock &state, bool p1,
+                              Decision type, const Pile &hand,
+                              CardMask options, int min, int max,
+                              std::vector<int> *picks) {
+    picks->clear();
+    CardMask legal = KindsIn(hand, options);
+    int numLegal = 0;
+    for(size_t i = 0; i < hand.Size(); i++) {
+        numLegal += InMask(legal, hand.At(i));
+    }
+    max = std::min(max, numLegal);
+    min = std::min(min, max);
+    if(max <= 0) {
+        co_return;
+    }
+    // Picking min of numLegal cards is forced if that's all of them, and
+    // picking copies of one kind gives the same result whichever they are
+    if(!state.autoResolve || (min < numLegal && (min < max ||
+                                                 !OneKind(legal)))) {
+        DecisionProvider *provider = For(state, p1);
+        StartClock(state, p1);
+        co_await Answered(provider, [&] {
+            picks->clear();
+            provider->ChooseManyFromHand(state, p1, type, hand, legal, min,
+                                         max, picks);
+        });
+        if((provider = StopClock(state, p1)) != NULL) {
+            picks->clear();
+            provider->ChooseManyFromHand(state, p1, type, hand, legal, min,
+                                         max, picks);
+        }
+    }
+    // Keep the legal, distinct answers up to `max` in place, then top up
+    // to `min`; the caller's buffer is reused so this doesn't allocate
+    std::bitset<MAX_ZONE_SIZE> taken;
+    size_t kept = 0;
+    for(int idx : *picks) {
+        if((int)kept < max && idx >= 0 && idx < (int)hand.Size() &&
+           !taken[idx] && InMask(legal, hand.At(idx))) {
+            taken[idx] = true;
+            (*picks)[kept++] = idx;
+        }
+    }
+    picks->resize(kept);
+    for(size_t i = 0; i < hand.Size() && (int)picks->size() < min; i++) {
+        if(!taken[i] && InMask(legal, hand.At(i))) {
+            taken[i] = true;
+            picks->push_back(i);
+        }
+    }
+    std::sort(picks->begin(), picks->end(), std::greater<int>());
+}
+
+Task<int> decision::FromSupply(const struct stateBlock &state, bool p1,
+                               Decision type, CardMask options, int maxCost,
+                               bool canDecline) {
+    const Supply &kingdom = *state.kingdom;
+    CardMask legal = options & kingdom.BuyableAtMost(maxCost);
+    if(legal == 0) {
+        if(!canDecline || state.autoResolve) {
+            co_return DEF_CHOICE;
+        }
+    } else if(state.autoResolve && !canDecline && OneKind(legal)) {
+        for(size_t i = 0; i < kingdom.Size(); i++) {
+            if(InMask(legal, kingdom.At(i).GetTopCard())) {
+                co_return i;
+            }
+        }
+    }
+    DecisionProvider *provider = For(state, p1);
+    int idx = DEF_CHOICE;
+    StartClock(state, p1);
+    co_await Answered(provider, [&] {
+        idx = provider->ChooseFromSupply(state, p1, type, legal, maxCost,
+                                         canDecline);
+    });
+    if((provider = StopClock(state, p1)) != NULL) {
+        idx = provider->ChooseFromSupply(state, p1, type, legal, maxCost,
+                                         canDecline);
+    }
+    if(idx >= 0 && idx < (int)kingdom.Size() &&
+       InMask(legal, kingdom.At(idx).GetTopCard())) {
+        co_return idx;
+    }
+    if(canDecline) {
+        co_return DEF_CHOICE;
+    }
+    for(size_t i = 0; i < kingdom.Size(); i++) {
+        if(InMask(legal, kingdom.At(i).GetTopCard())) {
+            co_return i;
+        }
+    }
+    co_return DEF_CHOICE;
+}
+
+Task<bool> decision::YesNo(const struct stateBlock &state, bool p1,
+                           Decision type, CardId card) {
+    DecisionProvider *provider = For(state, p1);
+    bool yes = false;
+    StartClock(state, p1);
+    co_await Answered(provider, [&] {
+        yes = provider->ChooseYesNo(state, p1, type, card);
+    });
+    if((provider = StopClock(state, p1)) != NULL) {
+        yes = provider->ChooseYesNo(state, p1, type, card);
+    }
+    co_return yes;
+}
+
+bool decision::ParseFallback(std::string_view name, Fallback *fallback) {
+    if(name == "pass") {
+        *fallback = FALLBACK_PASS;
+    } else if(name == "first") {
+        *fallback = FALLBACK_FIRST_LEGAL;
+    } else if(name == "heuristic") {
+        *fallback = FALLBACK_HEURISTIC;
+    } else {
+        return false;
+    }
+    return true;
+}
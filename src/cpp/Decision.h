@@ -0,0 +1,226 @@
+/* DOMINION
+ * David Mally, Richard Roberts
+ * Decision.h
+ * Defines the interface the engine asks whenever a player has to make a
+ * choice, one provider that asks a person over stdin/stdout and one that
+ * answers in-process for bots. The engine awaits each choice, so a game
+ * whose answer hasn't arrived yet can be suspended until it has.
+ */
+#ifndef __DECISION_H__
+#define __DECISION_H__
+
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "Card.h"
+#include "InputReader.h"
+#include "Pile.h"
+#include "Supply.h"
+#include "Task.h"
+
+struct stateBlock;
+
+// Sent to a stdin player before each question while their clock runs,
+// followed by the milliseconds this answer may take and those left for
+// the game (-1 if the game has no budget)
+#define CLOCK_HEADER "@@CLOCK@@: "
+// Sent to a stdin player whose answer didn't come in time, once the
+// fallback has answered for them
+#define TIMEOUT_LINE "@@TIMEOUT@@"
+// Sent to a stdin player before they pick several cards from their hand,
+// followed by the Decision, the fewest and most cards to pick, and the
+// hand's cards by name in index order
+#define PICK_HEADER "@@PICK@@: "
+
+// Every point in the game where a player has to choose something
+enum Decision {
+    DEC_PLAY_ACTION,    // hand: action to play, or decline to end the phase
+    DEC_PLAY_TREASURE,  // hand: treasure to play, or decline to end the phase
+    DEC_BUY,            // supply: card to buy, or decline to end the phase
+    DEC_CELLAR,         // hand, many: cards to discard
+    DEC_CHAPEL,         // hand, many: cards to trash
+    DEC_CHANCELLOR,     // yes/no: put the deck into the discard pile
+    DEC_WORKSHOP,       // supply: card to gain
+    DEC_FEAST,          // supply: card to gain
+    DEC_MILITIA,        // hand, many: cards the attacked player discards
+    DEC_MONEYLENDER,    // yes/no: trash a copper
+    DEC_REMODEL_TRASH,  // hand: card to trash
+    DEC_REMODEL_GAIN,   // supply: card to gain
+    DEC_SPY_SELF,       // yes/no: discard your own top card
+    DEC_SPY_OTHER,      // yes/no: discard the opponent's top card
+    DEC_THIEF_TRASH,    // yes/no: trash the revealed treasure
+    DEC_THIEF_GAIN,     // yes/no: gain the treasure just trashed
+    DEC_THRONEROOM,     // hand: action to play twice
+    DEC_LIBRARY,        // yes/no: set the drawn action aside
+    DEC_MINE_TRASH,     // hand: treasure to trash
+    DEC_MINE_GAIN,      // supply: treasure to gain
+    NUM_DECISIONS
+};
+
+// Answers the engine's questions for one player. `p1` says which player
+// is deciding; `state` is the whole game, read-only. Options are given as
+// CardMasks of the card kinds that are legal picks.
+class DecisionProvider {
+    public:
+        virtual ~DecisionProvider(void) {}
+        // Returns the index in `hand` of a card whose kind is in
+        // `options`, or DEF_CHOICE if `canDecline`
+        virtual int ChooseFromHand(const struct stateBlock &state, bool p1,
+                                   Decision type, const Pile &hand,
+                                   CardMask options, bool canDecline) = 0;
+        // Fills `picks` with `min` to `max` distinct indices into `hand`
+        // whose kinds are in `options`
+        virtual void ChooseManyFromHand(const struct stateBlock &state,
+                                        bool p1, Decision type,
+                                        const Pile &hand, CardMask options,
+                                        int min, int max,
+                                        std::vector<int> *picks) = 0;
+        // Returns the index of a supply pile whose card is in `options`,
+        // or DEF_CHOICE if `canDecline`. Every option costs <= `maxCost`.
+        virtual int ChooseFromSupply(const struct stateBlock &state, bool p1,
+                                     Decision type, CardMask options,
+                                     int maxCost, bool canDecline) = 0;
+        // Answers a yes/no question about `card`
+        virtual bool ChooseYesNo(const struct stateBlock &state, bool p1,
+                                 Decision type, CardId card) = 0;
+        // Whether the answer to the question just asked hasn't arrived, so
+        // what was returned means nothing. The game is then suspended (see
+        // Park) and the same question asked again once it is resumed. Only
+        // a provider that can't wait in place for an answer says so.
+        virtual bool Pending(void) { return false; }
+        // Holds on to the suspended game until this provider's answer has
+        // arrived, for whoever delivers the answer to resume
+        virtual void Park(std::coroutine_handle<>) {}
+};
+
+// Prompts on stdout and reads answers from stdin (see decision::Input),
+// re-asking until the answer is legal. This is the text protocol the
+// game has always used; a multi-select is answered with one line of
+// hand indices.
+class StdinDecider : public DecisionProvider {
+    public:
+        int ChooseFromHand(const struct stateBlock &state, bool p1,
+                           Decision type, const Pile &hand,
+                           CardMask options, bool canDecline);
+        void ChooseManyFromHand(const struct stateBlock &state, bool p1,
+                                Decision type, const Pile &hand,
+                                CardMask options, int min, int max,
+                                std::vector<int> *picks);
+        int ChooseFromSupply(const struct stateBlock &state, bool p1,
+                             Decision type, CardMask options,
+                             int maxCost, bool canDecline);
+        bool ChooseYesNo(const struct stateBlock &state, bool p1,
+                         Decision type, CardId card);
+};
+
+// Answers in-process with no I/O: plays the first legal card, gains the
+// most expensive legal card, picks as few cards as allowed and says no.
+// Bots derive from it and override the decisions they care about.
+class BotDecider : public DecisionProvider {
+    public:
+        int ChooseFromHand(const struct stateBlock &state, bool p1,
+                           Decision type, const Pile &hand,
+                           CardMask options, bool canDecline);
+        void ChooseManyFromHand(const struct stateBlock &state, bool p1,
+                                Decision type, const Pile &hand,
+                                CardMask options, int min, int max,
+                                std::vector<int> *picks);
+        int ChooseFromSupply(const struct stateBlock &state, bool p1,
+                             Decision type, CardMask options,
+                             int maxCost, bool canDecline);
+        bool ChooseYesNo(const struct stateBlock &state, bool p1,
+                         Decision type, CardId card);
+};
+
+// What answers for a player whose time ran out. None of them plays an
+// action: the action phase just ends.
+enum Fallback {
+    FALLBACK_PASS,          // decline where allowed, else the first legal
+    FALLBACK_FIRST_LEGAL,   // the first legal option, even where declining
+                            // is allowed
+    FALLBACK_HEURISTIC      // whatever BotDecider would answer
+};
+
+// One player's time control: each answer may take up to a move budget,
+// and all their answers in a game up to a game budget (0 for no limit).
+// The decision wrappers run it around every question they ask. Over
+// stdin, a late answer is cut off at the deadline; any other provider is
+// waited for, but an answer that comes late is thrown away all the same.
+// Either way the fallback answers instead and the timeout is counted.
+class PlayerClock {
+    private:
+        int64_t m_moveMs;
+        int64_t m_gameMs;
+        Fallback m_fallback;
+        int64_t m_usedMs;
+        int m_timeouts;
+        std::chrono::steady_clock::time_point m_start;
+        std::chrono::steady_clock::time_point m_deadline;
+    public:
+        PlayerClock(void);
+        void Set(int64_t moveMs, int64_t gameMs, Fallback fallback);
+        // Whether there is any budget to keep to
+        bool IsSet(void) const;
+        // Starts a new game: nothing used and no timeouts
+        void Reset(void);
+        // Starts timing an answer, and returns when it is due
+        std::chrono::steady_clock::time_point Start(void);
+        // Stops timing it. Returns true, and counts a timeout, if it came
+        // after the deadline or `cutOff` says it never came.
+        bool Stop(bool cutOff);
+        // Milliseconds left of the game budget, or -1 if there is none
+        int64_t GameLeftMs(void) const;
+        Fallback GetFallback(void) const;
+        int64_t GetUsedMs(void) const;
+        int GetTimeouts(void) const;
+};
+
+// What the engine calls. These find the deciding player's provider, ask
+// it, and check the answer: an illegal answer counts as declining where
+// that's allowed and as the first legal option where it isn't, so a
+// misbehaving provider can't stall the game. A question that must be
+// answered but has no legal answer isn't asked at all, and neither, with
+// stateBlock::autoResolve, is one with only one legal outcome. A player
+// with a PlayerClock is timed while they answer. Each is awaited by the
+// phase or effect asking, and suspends it while the answer is Pending.
+namespace decision {
+    // Returns the provider for player 1 or 2, or a shared StdinDecider
+    // if the state doesn't name one. Once stdin has run out a BotDecider
+    // answers in its place.
+    DecisionProvider *For(const struct stateBlock &state, bool p1);
+    // Returns true if the player answers over stdin, so the text protocol
+    // (GSV blocks and prompts) has a reader
+    bool IsStdin(const struct stateBlock &state, bool p1);
+    // Returns true if the player answers over stdin and hasn't already
+    // sent the answer to the next question, so a prompt or GSV would be
+    // read. An agent that knows its plan can send a whole phase or turn
+    // of answers at once and skip them.
+    bool WantsPrompt(const struct stateBlock &state, bool p1);
+    // Returns the kinds of card in `pile` that are also in `options`
+    CardMask KindsIn(const Pile &pile, CardMask options);
+    Task<int> FromHand(const struct stateBlock &state, bool p1,
+                       Decision type, const Pile &hand, CardMask options,
+                       bool canDecline);
+    // Leaves the picks in `picks`, sorted from highest index to lowest so
+    // they can be moved out of the hand one after another
+    Task<> ManyFromHand(const struct stateBlock &state, bool p1,
+                        Decision type, const Pile &hand, CardMask options,
+                        int min, int max, std::vector<int> *picks);
+    Task<int> FromSupply(const struct stateBlock &state, bool p1,
+                         Decision type, CardMask options, int maxCost,
+                         bool canDecline);
+    Task<bool> YesNo(const struct stateBlock &state, bool p1, Decision type,
+                     CardId card);
+    // Has StdinDecider read its answers from `reader`; NULL goes back to
+    // stdin. Per thread, like game_state::SetOutput.
+    void SetInput(InputReader *reader);
+    // Where StdinDecider reads its answers
+    InputReader &Input(void);
+    // Reads "pass", "first" or "heuristic" into `fallback`; returns false
+    // for anything else
+    bool ParseFallback(std::string_view name, Fallback *fallback);
+}
+
+#endif
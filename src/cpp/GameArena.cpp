@@ -0,0 +1,92 @@
+/* DOMINION
+ * David Mally, Richard Roberts
+ * GameArena.cpp
+ * Defines GameArena class, which owns every object that lives for the
+ * length of one game (players, trash, kingdom) and hands out the
+ * stateBlock pointing at them.
+ */
+#include <vector>
+
+#include "GameArena.h"
+#include "CardLookup.h"
+#include "GameState.h"
+
+GameArena::GameArena(uint64_t seed, std::vector<CardId> cardSet)
+    : m_rng(seed), m_p1(P1_NUM, "p1", &m_rng), m_p2(P2_NUM, "p2", &m_rng),
+      m_trash(TRASH) {
+    m_trash.Reserve(MAX_ZONE_SIZE);
+    m_picks.reserve(MAX_ZONE_SIZE);
+    m_setAside.Reserve(MAX_ZONE_SIZE);
+    m_kingdom = game_state::GenerateKingdom(cardSet, &m_rng);
+
+    m_state.p1      = &m_p1;
+    m_state.p2      = &m_p2;
+    m_state.trash   = &m_trash;
+    m_state.kingdom = &m_kingdom;
+    m_state.p1Gsv   = &m_p1Gsv;
+    m_state.p2Gsv   = &m_p2Gsv;
+    m_state.p1Clock = &m_p1Clock;
+    m_state.p2Clock = &m_p2Clock;
+    m_state.picks    = &m_picks;
+    m_state.setAside = &m_setAside;
+}
+
+void GameArena::Reset(std::vector<CardId> cardSet) {
+    m_p1.Reset();
+    m_p2.Reset();
+    m_trash.EmptyDeck();
+    // Left holding cards if the last game was thrown away mid-effect
+    m_setAside.EmptyDeck();
+    m_kingdom = game_state::GenerateKingdom(cardSet, &m_rng);
+    m_p1Gsv.Resync();
+    m_p2Gsv.Resync();
+    m_p1Clock.Reset();
+    m_p2Clock.Reset();
+}
+
+void GameArena::SetLazyShuffle(bool lazy) {
+    m_p1.SetLazyShuffle(lazy);
+    m_p2.SetLazyShuffle(lazy);
+}
+
+void GameArena::Seed(uint64_t seed) {
+    m_rng.Seed(seed);
+}
+
+void GameArena::Seed(uint64_t seed, uint64_t game) {
+    m_rng.Seed(seed, game);
+}
+
+void GameArena::SetDeciders(DecisionProvider *p1Decider,
+                            DecisionProvider *p2Decider) {
+    m_state.p1Decider = p1Decider;
+    m_state.p2Decider = p2Decider;
+}
+
+void GameArena::SetDeltaGsv(bool delta) {
+    m_p1Gsv.SetDelta(delta);
+    m_p2Gsv.SetDelta(delta);
+}
+
+void GameArena::SetLazyGsv(bool lazy) {
+    m_p1Gsv.SetLazy(lazy);
+    m_p2Gsv.SetLazy(lazy);
+}
+
+void GameArena::SetAutoResolve(bool autoResolve) {
+    m_state.autoResolve = autoResolve;
+}
+
+void GameArena::SetAutoTreasures(bool autoTreasures) {
+    m_state.autoTreasures = autoTreasures;
+}
+
+void GameArena::SetTimeControl(int64_t moveMs, int64_t gameMs,
+                               Fallback fallback) {
+    m_p1Clock.Set(moveMs, gameMs, fallback);
+    m_p2Clock.Set(moveMs, gameMs, fallback);
+}
+
+struct stateBlock *GameArena::GetState(void) {
+    return &m_state;
+}
@@ -0,0 +1,84 @@
+/* DOMINION
+ * David Mally, Richard Roberts
+ * GameArena.h
+ * Defines GameArena class, which owns every object that lives for the
+ * length of one game (players, trash, kingdom) and hands out the
+ * stateBlock pointing at them.
+ */
+#ifndef __GAMEARENA_H__
+#define __GAMEARENA_H__
+
+#include <vector>
+
+#include "Card.h"
+#include "Pile.h"
+#include "SupplyPile.h"
+#include "Supply.h"
+#include "Player.h"
+#include "GameState.h"
+#include "CardLookup.h"
+#include "Decision.h"
+#include "RandUtils.h"
+
+#define P1_NUM 1
+#define P2_NUM 2
+
+class GameArena {
+    private:
+        // Declared first: the players hold a pointer to it
+        rand_utils::Rng m_rng;
+        Player m_p1;
+        Player m_p2;
+        Pile m_trash;
+        Supply m_kingdom;
+        GsvLog m_p1Gsv;
+        GsvLog m_p2Gsv;
+        PlayerClock m_p1Clock;
+        PlayerClock m_p2Clock;
+        std::vector<int> m_picks;
+        Pile m_setAside;
+        struct stateBlock m_state;
+    public:
+        // Sets up storage for a game and deals the first one. Every
+        // shuffle and kingdom draw comes from a generator seeded with
+        // `seed`, so the same seed replays the same games.
+        GameArena(uint64_t seed = DEF_SEED,
+                  std::vector<CardId> cardSet = lookup::GenAllCards());
+        // The state block points into the arena, so it can't be copied
+        GameArena(const GameArena &other) = delete;
+        GameArena &operator=(const GameArena &other) = delete;
+        // Throws away the current game in one shot and deals a new one
+        // from `cardSet` into the same storage
+        void Reset(std::vector<CardId> cardSet = lookup::GenAllCards());
+        // Switches both players to lazy reshuffles (see
+        // Player::SetLazyShuffle); takes effect from the next shuffle
+        void SetLazyShuffle(bool lazy);
+        // Reseeds the arena's generator; takes effect from the next Reset
+        void Seed(uint64_t seed);
+        // Reseeds for game `game` of the campaign seeded with `seed`.
+        // The next Reset deals that game regardless of which arena or
+        // thread it runs on.
+        void Seed(uint64_t seed, uint64_t game);
+        // Has `p1Decider` and `p2Decider` answer the players' choices;
+        // NULL asks over stdin/stdout. The arena doesn't own them.
+        void SetDeciders(DecisionProvider *p1Decider,
+                         DecisionProvider *p2Decider);
+        // Sends GSVs as deltas (see GsvLog) instead of in full
+        void SetDeltaGsv(bool delta);
+        // Sends GSVs only when the agent asks (see GsvLog)
+        void SetLazyGsv(bool lazy);
+        // Answers questions with one legal outcome for the players (see
+        // stateBlock::autoResolve)
+        void SetAutoResolve(bool autoResolve);
+        // Plays every treasure in hand at once
+        void SetAutoTreasures(bool autoTreasures);
+        // Gives both players `moveMs` per answer and `gameMs` per game (0
+        // for no limit), with `fallback` answering when they run out (see
+        // PlayerClock)
+        void SetTimeControl(int64_t moveMs, int64_t gameMs,
+                            Fallback fallback);
+        // Returns the state block for the current game
+        struct stateBlock *GetState(void);
+};
+
+#endif
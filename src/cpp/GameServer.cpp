@@ -0,0 +1,340 @@
+/* DOMINION
+ * David Mally, Richard Roberts
+ * GameServer.cpp
+ * Defines GameServer class, and the games it hosts: each is a coroutine
+ * that suspends, back to the event loop, whenever it needs an answer the
+ * agent hasn't sent yet.
+ */
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "GameServer.h"
+#include "GameArena.h"
+#include "GameState.h"
+#include "Protocol.h"
+#include "Task.h"
+
+struct Connection {
+    int fd;
+    // Bytes read that don't make a whole reply yet
+    std::string in;
+    // Frames not yet written
+    std::string out;
+    // Whether epoll is also watching for room to write
+    bool watchingOut = false;
+    std::unordered_map<uint32_t, std::unique_ptr<ServerGame>> games;
+};
+
+// One hosted game. It is also the streambuf its BinaryDecider reads and
+// writes: each flushed record goes out as one frame tagged with the
+// game's id, and a question with no reply yet suspends the game.
+class ServerGame : public std::streambuf {
+    private:
+        Connection *m_conn;
+        uint32_t m_id;
+        GameArena m_arena;
+        std::istream m_in;
+        std::ostream m_out;
+        BinaryDecider m_decider;
+        // Reply bytes handed over by the loop, and the ones being read
+        std::string m_replies;
+        std::string m_reading;
+        // The record being written
+        std::string m_record;
+        // Declared last, so the game's frames go before what they use.
+        // Destroying a game that is waiting frees every frame it holds.
+        Task<> m_play;
+        Task<> Play(void);
+    protected:
+        std::streamsize showmanyc(void);
+        int_type underflow(void);
+        std::streamsize xsputn(const char *data, std::streamsize size);
+        int_type overflow(int_type c);
+        int sync(void);
+    public:
+        // Deals the game and plays until the first question
+        ServerGame(Connection *conn, uint32_t id, uint64_t seed,
+                   uint64_t game, const GameOptions &options);
+        // Carries on from the question the game is waiting on, until it
+        // next waits or ends
+        void Resume(void);
+        bool Done(void) const { return m_play.Done(); }
+        // Queues a reply (count byte included) for the game to read
+        void Reply(const char *data, size_t size) {
+            m_replies.append(data, size);
+        }
+};
+
+namespace {
+    void Put32(std::string *frame, uint32_t value) {
+        for(int i = 0; i < 4; i++) {
+            frame->push_back((char)((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    uint32_t Get32(const std::string &data, size_t at) {
+        uint32_t value = 0;
+        for(int i = 0; i < 4; i++) {
+            value |= (uint32_t)(uint8_t)data[at + i] << (8 * i);
+        }
+        return value;
+    }
+}
+
+ServerGame::ServerGame(Connection *conn, uint32_t id, uint64_t seed,
+                       uint64_t game, const GameOptions &options)
+    : m_conn(conn), m_id(id), m_in(this), m_out(this),
+      m_decider(&m_in, &m_out, true) {
+    m_arena.Seed(seed, game);
+    m_arena.Reset();
+    m_arena.SetDeciders(&m_decider, &m_decider);
+    m_arena.SetDeltaGsv(options.delta);
+    m_arena.SetAutoResolve(options.autoResolve);
+    m_arena.SetAutoTreasures(options.autoTreasures);
+    m_arena.SetTimeControl(options.moveMs, options.gameMs,
+                           options.fallback);
+    m_play = Play();
+}
+
+Task<> ServerGame::Play(void) {
+    struct stateBlock *state = m_arena.GetState();
+    bool p1Turn = true;
+    while(!game_state::GameOver(*state->kingdom)) {
+        co_await game_state::ActionPhase(state, p1Turn);
+        co_await game_state::TreasurePhase(state, p1Turn);
+        co_await game_state::BuyPhase(state, p1Turn);
+        game_state::CleanupPhase(state, p1Turn);
+        p1Turn = !p1Turn;
+    }
+    m_decider.GameOver(*state);
+}
+
+void ServerGame::Resume(void) {
+    std::coroutine_handle<> game = m_decider.TakeParked();
+    if(game) {
+        game.resume();
+    }
+}
+
+std::streamsize ServerGame::showmanyc(void) {
+    return m_replies.size();
+}
+
+ServerGame::int_type ServerGame::underflow(void) {
+    // The decider only reads once showmanyc says a reply is there
+    if(m_replies.empty()) {
+        return traits_type::eof();
+    }
+    m_reading.swap(m_replies);
+    m_replies.clear();
+    setg(&m_reading[0], &m_reading[0], &m_reading[0] + m_reading.size());
+    return traits_type::to_int_type(*gptr());
+}
+
+std::streamsize ServerGame::xsputn(const char *data, std::streamsize size) {
+    m_record.append(data, size);
+    return size;
+}
+
+ServerGame::int_type ServerGame::overflow(int_type c) {
+    if(!traits_type::eq_int_type(c, traits_type::eof())) {
+        m_record.push_back(traits_type::to_char_type(c));
+    }
+    return traits_type::not_eof(c);
+}
+
+int ServerGame::sync(void) {
+    if(!m_record.empty()) {
+        Put32(&m_conn->out, m_id);
+        m_conn->out += m_record;
+    }
+    m_record.clear();
+    return 0;
+}
+
+GameServer::GameServer(uint64_t seed, const GameOptions &options)
+    : m_listen(-1), m_epoll(epoll_create1(0)),
+      m_stop(eventfd(0, EFD_NONBLOCK)), m_seed(seed), m_gamesStarted(0),
+      m_options(options) {
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = m_stop;
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_stop, &event);
+}
+
+GameServer::~GameServer(void) {
+    while(!m_conns.empty()) {
+        Drop(m_conns.begin()->second.get());
+    }
+    if(m_listen != -1) {
+        close(m_listen);
+        unlink(m_path.c_str());
+    }
+    close(m_stop);
+    close(m_epoll);
+}
+
+bool GameServer::Listen(const std::string &path) {
+    struct sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    if(path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    strcpy(addr.sun_path, path.c_str());
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if(fd == -1) {
+        return false;
+    }
+    unlink(path.c_str());
+    if(bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1 ||
+       listen(fd, SERVER_BACKLOG) == -1) {
+        close(fd);
+        return false;
+    }
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event);
+    m_listen = fd;
+    m_path = path;
+    return true;
+}
+
+void GameServer::Stop(void) {
+    uint64_t one = 1;
+    if(write(m_stop, &one, sizeof(one)) == -1) {
+        // The counter is already nonzero, so the loop wakes anyway
+    }
+}
+
+void GameServer::Run(void) {
+    // Nobody is at a terminal
+    game_state::SetOutput(NULL);
+    struct epoll_event events[SERVER_MAX_EVENTS];
+    while(true) {
+        int count = epoll_wait(m_epoll, events, SERVER_MAX_EVENTS, -1);
+        if(count == -1 && errno != EINTR) {
+            return;
+        }
+        for(int i = 0; i < count; i++) {
+            int fd = events[i].data.fd;
+            if(fd == m_stop) {
+                uint64_t value;
+                if(read(m_stop, &value, sizeof(value)) == -1) {
+                    // Another Run() call took it
+                }
+                return;
+            } else if(fd == m_listen) {
+                Accept();
+                continue;
+            }
+            auto found = m_conns.find(fd);
+            if(found == m_conns.end()) {
+                continue;
+            }
+            Connection *conn = found->second.get();
+            if(events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                Receive(conn);
+            } else if(events[i].events & EPOLLOUT) {
+                Flush(conn);
+            }
+        }
+    }
+}
+
+void GameServer::Accept(void) {
+    int fd;
+    while((fd = accept4(m_listen, NULL, NULL, SOCK_NONBLOCK)) != -1) {
+        struct epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event);
+        std::unique_ptr<Connection> conn(new Connection());
+        conn->fd = fd;
+        m_conns[fd] = std::move(conn);
+    }
+}
+
+void GameServer::Receive(Connection *conn) {
+    char buf[SERVER_READ_BYTES];
+    ssize_t got;
+    while((got = read(conn->fd, buf, sizeof(buf))) > 0) {
+        conn->in.append(buf, got);
+    }
+    // A hung-up agent still gets the answers to the replies it sent first
+    bool closed = got == 0 || (errno != EAGAIN && errno != EWOULDBLOCK &&
+                               errno != EINTR);
+    // Each whole reply goes to its game, which then runs until it needs
+    // the next one; other games' replies are handled in between
+    size_t at = 0;
+    while(conn->in.size() - at >= 5 &&
+          conn->in.size() - at >= 5 + (size_t)(uint8_t)conn->in[at + 4]) {
+        uint32_t id = Get32(conn->in, at);
+        size_t size = 1 + (uint8_t)conn->in[at + 4];
+        auto found = conn->games.find(id);
+        ServerGame *game;
+        if(found == conn->games.end()) {
+            game = new ServerGame(conn, id, m_seed, m_gamesStarted++,
+                                  m_options);
+            conn->games[id].reset(game);
+        } else {
+            game = found->second.get();
+            game->Reply(&conn->in[at + 4], size);
+            game->Resume();
+        }
+        if(game->Done()) {
+            conn->games.erase(id);
+        }
+        at += 4 + size;
+    }
+    conn->in.erase(0, at);
+    Flush(conn);
+    if(closed) {
+        Drop(conn);
+    }
+}
+
+void GameServer::Flush(Connection *conn) {
+    while(!conn->out.empty()) {
+        // An agent that has gone away fails the send instead of raising
+        // SIGPIPE
+        ssize_t sent = send(conn->fd, conn->out.data(), conn->out.size(),
+                            MSG_NOSIGNAL);
+        if(sent <= 0) {
+            break;
+        }
+        conn->out.erase(0, sent);
+    }
+    bool watch = !conn->out.empty();
+    if(watch != conn->watchingOut) {
+        uint32_t events = EPOLLIN;
+        if(watch) {
+            events |= EPOLLOUT;
+        }
+        struct epoll_event event = {};
+        event.events = events;
+        event.data.fd = conn->fd;
+        epoll_ctl(m_epoll, EPOLL_CTL_MOD, conn->fd, &event);
+        conn->watchingOut = watch;
+    }
+}
+
+void GameServer::Drop(Connection *conn) {
+    // Each game is suspended on a question, so destroying it frees its
+    // frames where they stand
+    conn->games.clear();
+    epoll_ctl(m_epoll, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    m_conns.erase(conn->fd);
+}
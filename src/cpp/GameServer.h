@@ -0,0 +1,94 @@
+/* DOMINION
+ * David Mally, Richard Roberts
+ * GameServer.h
+ * Declares GameServer class, which hosts many games at once in one
+ * process: agents connect over a Unix domain socket and play any number
+ * of games each through the binary protocol, on one epoll event loop.
+ */
+#ifndef __GAME_SERVER_H__
+#define __GAME_SERVER_H__
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "Decision.h"
+
+// Connections a listening socket queues before they're accepted
+#define SERVER_BACKLOG 64
+// Events taken from epoll per wakeup
+#define SERVER_MAX_EVENTS 64
+// Bytes read from a connection at a time
+#define SERVER_READ_BYTES 65536
+
+class ServerGame;
+struct Connection;
+
+// How every hosted game is played. Each is the GameArena setting of the
+// same name, off by default.
+struct GameOptions {
+    bool delta = false;
+    bool autoResolve = false;
+    bool autoTreasures = false;
+    int64_t moveMs = 0;
+    int64_t gameMs = 0;
+    Fallback fallback = FALLBACK_HEURISTIC;
+};
+
+/* Each game is a coroutine (see Task): while it waits for an answer it
+ * is suspended with nothing but its frames on the heap, and the loop
+ * resumes it when the answer arrives.
+ *
+ * Every message either way starts with a little-endian u32 game id,
+ * which the agent picks. The rest is what one game's --binary stream
+ * carries (see Protocol.h):
+ *
+ *   server -> agent   u32 gameId, then one record (its own u32 length
+ *                     and body)
+ *   agent -> server   u32 gameId, then one reply (u8 count and count
+ *                     u8 values)
+ *
+ * A reply naming an id the connection has no game for starts a new game
+ * under that id (its values are ignored); the server answers with the
+ * game's first record. A game ends with its DEC_GAME_OVER record, after
+ * which the id is free again. While the agent thinks about one game the
+ * server carries on with every other game that has an answer. */
+class GameServer {
+    private:
+        int m_listen;
+        int m_epoll;
+        // Written by Stop() to wake the loop from another thread
+        int m_stop;
+        std::string m_path;
+        // Game n played here is game n of the campaign seeded with
+        // m_seed (see GameArena::Seed)
+        uint64_t m_seed;
+        uint64_t m_gamesStarted;
+        GameOptions m_options;
+        std::unordered_map<int, std::unique_ptr<Connection>> m_conns;
+        void Accept(void);
+        // Reads what has arrived and hands every whole reply to its game,
+        // then drops the connection if the agent has hung up
+        void Receive(Connection *conn);
+        // Writes as much pending output as the socket takes, and has
+        // epoll say when it takes more
+        void Flush(Connection *conn);
+        // Ends every game on `conn` where it stands, then closes it
+        void Drop(Connection *conn);
+    public:
+        explicit GameServer(uint64_t seed,
+                            const GameOptions &options = GameOptions());
+        GameServer(const GameServer &other) = delete;
+        GameServer &operator=(const GameServer &other) = delete;
+        ~GameServer(void);
+        // Listens on the Unix domain socket `path`, replacing any file
+        // already there. Returns false if it can't.
+        bool Listen(const std::string &path);
+        // Serves connections until Stop() is called
+        void Run(void);
+        // Makes Run() return; safe to call from any thread
+        void Stop(void);
+};
+
+#endif
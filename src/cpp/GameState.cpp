@@ -6,17 +6,19 @@
  * showing the splash screen, setting text color, etc.
  */
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <vector>
-#include <unordered_map>
 
 #include "Card.h"
-#include "ActionCard.h"
 #include "RandUtils.h"
 #include "GameState.h"
 #include "CardLookup.h"
+#include "Decision.h"
 #include "Pile.h"
+#include "SupplyPile.h"
+#include "Supply.h"
 #include "Player.h"
 #include "Defs.h"
 
@@ -35,68 +37,47 @@ struct GameStateVector {
   std::vector<std::pair<std::string, int>> trash;
 };
 
-GameStateVector GetGameStateVector(Player *player1, Player *player2, std::string phase, std::vector<Pile> *kingdom, Pile *trash) {
+// Appends (name, count) for every card kind present in `pile`, in CardId
+// order, straight from the pile's running counts
+void TallyPile(const Pile &pile, std::vector<std::pair<std::string, int>> *tally) {
+  for(CardId card = 0; card < NUM_CARDS; card++) {
+    if(pile.Contains(card)) {
+      tally->push_back(std::make_pair(lookup::GetCard(card).GetName(), pile.Count(card)));
+    }
+  }
+}
+
+GameStateVector GetGameStateVector(Player *player1, Player *player2, std::string phase, Supply *kingdom, Pile *trash) {
   GameStateVector gsv;
   gsv.player = player1->GetName();
   gsv.num_actions = player1->GetActions();
   gsv.num_buys = player1->GetBuys();
   gsv.num_coins = player1->GetCoins();
-  gsv.player_score = game_state::ScoreDeck(player1->GetDeck()) + game_state::ScoreDeck(player1->GetHand()) + game_state::ScoreDeck(player1->GetDiscard());
-  gsv.opponent_score = game_state::ScoreDeck(player2->GetDeck()) + game_state::ScoreDeck(player2->GetHand()) + game_state::ScoreDeck(player2->GetDiscard());
+  gsv.player_score = player1->GetScore();
+  gsv.opponent_score = player2->GetScore();
   gsv.phase = phase;
 
-  auto deck = player1->GetDeck();
-  std::unordered_map<std::string, int> card_count;
-  for(auto card : deck.GetCards()) {
-    card_count[card->GetName()]++;
-  }
-  for (const auto & [ key, value ] : card_count) {
-      gsv.deck.push_back(make_pair(key, value));
-  }
+  TallyPile(player1->GetDeck(), &gsv.deck);
+  TallyPile(player1->GetHand(), &gsv.hand);
+  TallyPile(player1->GetDiscard(), &gsv.discard);
 
-  auto hand = player1->GetHand();
-  std::unordered_map<std::string, int> hand_count;
-  for(auto card : hand.GetCards()) {
-    hand_count[card->GetName()]++;
-  }
-  for (const auto & [ key, value ] : hand_count) {
-      gsv.hand.push_back(make_pair(key, value));
-  }
-
-  auto discard = player1->GetDiscard();
-  std::unordered_map<std::string, int> discard_count;
-  for(auto card : discard.GetCards()) {
-    discard_count[card->GetName()]++;
-  }
-  for (const auto & [ key, value ] : discard_count) {
-      gsv.discard.push_back(make_pair(key, value));
-  }
-
-  std::unordered_map<std::string, int> kingdom_count;
-  for(auto pile : *kingdom) {
-    for(auto card : pile.GetCards()) {
-      kingdom_count[card->GetName()]++;
+  // Empty piles are left out, like kinds absent from any other zone
+  for(const auto &pile : *kingdom) {
+    if(pile.Size() > 0) {
+      gsv.kingdom.push_back(std::make_pair(pile.GetName(), (int)pile.Size()));
     }
   }
-  for (const auto & [ key, value ] : kingdom_count) {
-      gsv.kingdom.push_back(make_pair(key, value));
-  }
 
-  std::unordered_map<std::string, int> trash_count;
-  for(auto card : trash->GetCards()) {
-    trash_count[card->GetName()]++;
-  }
-  for (const auto & [ key, value ] : trash_count) {
-      gsv.trash.push_back(make_pair(key, value));
-  }
+  TallyPile(*trash, &gsv.trash);
 
   return gsv;
 }
 
-std::string StringifyGSV(GameStateVector gsv) {
+// `seq` follows the header when the GSV is numbered (delta mode)
+std::string StringifyGSV(GameStateVector gsv, std::string seq = "") {
   std::string gsv_string;
 
-  gsv_string += "@@GSV@@: \n";
+  gsv_string += "@@GSV@@: " + seq + "\n";
   gsv_string += "@PRELIMINARY@\n";
 
   gsv_string += "*player: " + gsv.player + "*\n";
@@ -162,7 +143,101 @@ std::string StringifyGSV(GameStateVector gsv) {
   return gsv_string;
 }
 
-void OutputGSV(bool p1Turn, stateBlock state, std::string phase) {
+const char *GSV_COUNTER_NAMES[GSV_COUNTERS] = {
+  "num-actions", "num-buys", "num-coins", "player-score", "opponent-score"
+};
+const char *GSV_ZONE_NAMES[GSV_ZONES] = {
+  "PLAYER-DECK", "PLAYER-HAND", "PLAYER-DISCARD", "KINGDOM", "TRASH"
+};
+const int GSV_KINGDOM = 3;
+
+GsvLog::GsvLog(void) {
+  m_delta = false;
+  m_lazy = false;
+  m_sendFull = true;
+  m_seq = 0;
+}
+
+void GsvLog::SetDelta(bool delta) {
+  m_delta = delta;
+  m_sendFull = true;
+}
+
+std::string GsvLog::Next(const struct stateBlock &state, bool p1,
+                         const std::string &phase) {
+  Player *player = p1 ? state.p1 : state.p2;
+  Player *opponent = p1 ? state.p2 : state.p1;
+  int counters[GSV_COUNTERS] = {
+    player->GetActions(), player->GetBuys(), player->GetCoins(),
+    player->GetScore(), opponent->GetScore()
+  };
+  // Zones are counted by CardId, the kingdom by what each pile has left
+  uint16_t zones[GSV_ZONES][NUM_CARDS] = {};
+  const Pile *piles[GSV_ZONES] = {
+    &player->GetDeck(), &player->GetHand(), &player->GetDiscard(),
+    NULL /* GSV_KINGDOM */, state.trash
+  };
+  for(int zone = 0; zone < GSV_ZONES; zone++) {
+    for(CardId card = 0; piles[zone] != NULL && card < NUM_CARDS; card++) {
+      zones[zone][card] = piles[zone]->Count(card);
+    }
+  }
+  for(const SupplyPile &pile : *state.kingdom) {
+    zones[GSV_KINGDOM][pile.GetTopCard()] = pile.Size();
+  }
+
+  m_seq++;
+  std::string gsv_string;
+  if(m_sendFull) {
+    gsv_string = StringifyGSV(GetGameStateVector(player, opponent, phase,
+                                                 state.kingdom, state.trash),
+                              std::to_string(m_seq));
+  } else {
+    gsv_string += "@@GSV-DELTA@@: " + std::to_string(m_seq) + "\n";
+    std::string changed;
+    for(int i = 0; i < GSV_COUNTERS; i++) {
+      if(counters[i] != m_counters[i]) {
+        changed += std::string("*") + GSV_COUNTER_NAMES[i] + ": " +
+                   std::to_string(counters[i]) + "*\n";
+      }
+    }
+    if(phase != m_phase) {
+      changed += "*phase: " + phase + "*\n";
+    }
+    if(!changed.empty()) {
+      gsv_string += "@PRELIMINARY@\n" + changed;
+    }
+    // A kind that is gone shows up once with a count of 0
+    for(int zone = 0; zone < GSV_ZONES; zone++) {
+      changed.clear();
+      for(CardId card = 0; card < NUM_CARDS; card++) {
+        if(zones[zone][card] != m_zones[zone][card]) {
+          changed += std::string("*") + lookup::GetCard(card).GetName() +
+                     ", " + std::to_string(zones[zone][card]) + "*\n";
+        }
+      }
+      if(!changed.empty()) {
+        gsv_string += std::string("@") + GSV_ZONE_NAMES[zone] + "@\n" +
+                      changed;
+      }
+    }
+    gsv_string += "@@END OF GSV@@\n";
+  }
+
+  std::copy(counters, counters + GSV_COUNTERS, m_counters);
+  std::copy(&zones[0][0], &zones[0][0] + GSV_ZONES * NUM_CARDS,
+            &m_zones[0][0]);
+  m_phase = phase;
+  m_sendFull = false;
+  return gsv_string;
+}
+
+void WriteGSV(bool p1Turn, const stateBlock &state, std::string phase) {
+  GsvLog *log = p1Turn ? state.p1Gsv : state.p2Gsv;
+  if(log != NULL && log->IsDelta()) {
+    std::cout << log->Next(state, p1Turn, phase);
+    return;
+  }
   GameStateVector gsv;
   if(p1Turn) {
     gsv = GetGameStateVector(state.p1, state.p2, phase, state.kingdom, state.trash);
@@ -173,8 +248,36 @@ void OutputGSV(bool p1Turn, stateBlock state, std::string phase) {
   return;
 }
 
+// Sends the GSV at a prompt unless the player only wants it on request
+void OutputGSV(bool p1Turn, const stateBlock &state, std::string phase) {
+  GsvLog *log = p1Turn ? state.p1Gsv : state.p2Gsv;
+  if(log != NULL && log->IsLazy()) {
+    return;
+  }
+  WriteGSV(p1Turn, state, phase);
+}
+
+namespace {
+    // A stream with no buffer is permanently failed, so every write to it
+    // stops at the sentry without formatting anything
+    thread_local std::ostream nullOut(NULL);
+    thread_local std::ostream *outSink = &std::cout;
+}
+
+void game_state::SetOutput(std::ostream *sink) {
+    outSink = sink != NULL ? sink : &nullOut;
+}
+
+std::ostream &game_state::Out(void) {
+    return *outSink;
+}
+
+bool game_state::IsHeadless(void) {
+    return outSink == &nullOut;
+}
+
 void game_state::SetColor(const char color[]) {
-    std::cout << color;
+    Out() << color;
 }
 
 void game_state::SetColorByType(CardType type) {
@@ -201,26 +304,26 @@ void game_state::SetColorByType(CardType type) {
 }
 
 void game_state::ResetColor(void) {
-    std::cout << WHITE << RESET_BG << std::endl;
+    Out() << WHITE << RESET_BG << std::endl;
 }
 
 int game_state::SplashScreen(void) {
     game_state::SetColor(BLUE);
     game_state::SetColor(GREEN_BG);
-    std::cout << LOGO << std::endl;
+    Out() << LOGO << std::endl;
     game_state::ResetColor();
     int cmd = DEF_CHOICE;
     char pause;
     while(cmd < 0) {
-        std::cout << "Enter a choice below: " << std::endl;
-        std::cout << "(0) Start new game" << std::endl
-                  << "(1) List rules" << std::endl
-                  << "(2) Play demo game" << std::endl
-                  << "(3) Exit" << std::endl;
+        Out() << "Enter a choice below: " << std::endl;
+        Out() << "(0) Start new game" << std::endl
+              << "(1) List rules" << std::endl
+              << "(2) Play demo game" << std::endl
+              << "(3) Exit" << std::endl;
         std::cin >> cmd;
         lookup::CheckInvalidChoice(SPLASH_CHOICES, &cmd);
         if(cmd < 0) {
-            std::cout << "Invalid choice. Please try again." << std::endl;
+            Out() << "Invalid choice. Please try again." << std::endl;
         } else {
             switch(cmd) {
                 case NORMAL_GAME:
@@ -235,7 +338,7 @@ int game_state::SplashScreen(void) {
                     return DEMO_GAME;
                     break;
                 case EXIT_GAME:
-                    std::cout << "Exiting..." << std::endl;
+                    Out() << "Exiting..." << std::endl;
                     exit(0);
                     break;
             }
@@ -246,10 +349,13 @@ int game_state::SplashScreen(void) {
 }
 
 // Pick 10 random kingdom cards
-std::vector<Card> game_state::RandomizeKingdom(std::vector<Card> cardSet) {
-    std::vector<Card> randCards;
+std::vector<CardId> game_state::RandomizeKingdom(std::vector<CardId> cardSet,
+                                                 rand_utils::Rng *rng) {
+    std::vector<CardId> randCards;
 
-    std::vector<int> randVals = rand_utils::GenPseudoRandList(cardSet.size(), KINGDOM_SIZE, rand());
+    std::vector<int> randVals = rand_utils::GenPseudoRandList(cardSet.size(),
+                                                              KINGDOM_SIZE,
+                                                              rng);
 
     for(size_t i = 0; i < randVals.size(); i++) {
         randCards.push_back(cardSet.at(randVals.at(i)));
@@ -257,84 +363,85 @@ std::vector<Card> game_state::RandomizeKingdom(std::vector<Card> cardSet) {
     return randCards;
 }
 
-std::vector<Pile> game_state::GenerateKingdom(std::vector<Card> cardSet) {
-    std::vector<Card> randCards = RandomizeKingdom(cardSet);
-    std::vector<Pile> kingdomPiles;
+Supply game_state::GenerateKingdom(
+                                    std::vector<CardId> cardSet,
+                                    rand_utils::Rng *rng) {
+    std::vector<CardId> randCards = RandomizeKingdom(cardSet, rng);
+    std::vector<SupplyPile> kingdomPiles;
 
     // Generate action card piles
     for(size_t i = 0; i < randCards.size(); i++) {
-        Pile tmpPile(KINGDOM);
-        if(randCards.at(i).GetType() == VICTORY) {
-            tmpPile = Pile(KINGDOM, randCards.at(i), VICTORY_PILE_SIZE);
+        if(lookup::GetCard(randCards.at(i)).GetType() == VICTORY) {
+            kingdomPiles.push_back(SupplyPile(KINGDOM, randCards.at(i),
+                                              VICTORY_PILE_SIZE));
         } else {
-            tmpPile = Pile(KINGDOM, randCards.at(i), PILE_SIZE);
+            kingdomPiles.push_back(SupplyPile(KINGDOM, randCards.at(i),
+                                              PILE_SIZE));
         }
-        kingdomPiles.push_back(tmpPile);
     }
 
     // Generate victory/curse card piles
-    Pile victoryPile = Pile(KINGDOM, lookup::estate, VICTORY_PILE_SIZE,
-                           "estate");
-    kingdomPiles.push_back(victoryPile);
-
-    victoryPile = Pile(KINGDOM, lookup::duchy, VICTORY_PILE_SIZE,
-                           "duchy");
-    kingdomPiles.push_back(victoryPile);
-
-    victoryPile = Pile(KINGDOM, lookup::province, VICTORY_PILE_SIZE,
-                      "province");
-    kingdomPiles.push_back(victoryPile);
-
-    victoryPile = Pile(KINGDOM, lookup::curse, PILE_SIZE, "curse");
-    kingdomPiles.push_back(victoryPile);
+    kingdomPiles.push_back(SupplyPile(KINGDOM, CARD_ESTATE,
+                                      VICTORY_PILE_SIZE));
+    kingdomPiles.push_back(SupplyPile(KINGDOM, CARD_DUCHY,
+                                      VICTORY_PILE_SIZE));
+    kingdomPiles.push_back(SupplyPile(KINGDOM, CARD_PROVINCE,
+                                      VICTORY_PILE_SIZE));
+    kingdomPiles.push_back(SupplyPile(KINGDOM, CARD_CURSE, PILE_SIZE));
 
     // Generate treasure card piles
-    Pile treasurePile = Pile(TREASURE, lookup::copper, COPPER_PILE_SIZE,
-                            "copper");
-    kingdomPiles.push_back(treasurePile);
-
-    treasurePile = Pile(TREASURE, lookup::silver, SILVER_PILE_SIZE,
-                       "silver");
-    kingdomPiles.push_back(treasurePile);
+    kingdomPiles.push_back(SupplyPile(TREASURE, CARD_COPPER,
+                                      COPPER_PILE_SIZE));
+    kingdomPiles.push_back(SupplyPile(TREASURE, CARD_SILVER,
+                                      SILVER_PILE_SIZE));
+    kingdomPiles.push_back(SupplyPile(TREASURE, CARD_GOLD,
+                                      GOLD_PILE_SIZE));
+
+    return Supply(kingdomPiles);
+}
 
-    treasurePile = Pile(TREASURE, lookup::gold, GOLD_PILE_SIZE,
-                       "gold");
-    kingdomPiles.push_back(treasurePile);
+void game_state::SendGSV(const struct stateBlock &state, bool p1,
+                         std::string phase) {
+    WriteGSV(p1, state, phase);
+}
 
-    return kingdomPiles;
+void game_state::ResendGSV(const struct stateBlock &state, bool p1,
+                           std::string phase) {
+    GsvLog *log = p1 ? state.p1Gsv : state.p2Gsv;
+    if(log != NULL) {
+        log->Resync();
+    }
+    WriteGSV(p1, state, phase);
 }
 
-void game_state::ActionPhase(struct stateBlock *state, bool p1) {
+Task<> game_state::ActionPhase(struct stateBlock *state, bool p1) {
     Player *currPlayer = p1 ? state->p1 : state->p2;
     Player *otherPlayer = p1 ? state->p2 : state->p1;
-    int cmd;
+    int cmd = 0;
+    // Each turn opens with a full GSV
+    GsvLog *log = p1 ? state->p1Gsv : state->p2Gsv;
+    if(log != NULL) {
+        log->Resync();
+    }
     // system(CLEAR); // Clear the console
     PromptActionPhase();
-    Pile hand = currPlayer->GetHand();
+    const Pile &hand = currPlayer->GetHand();
     while(currPlayer->GetActions() > 0 && cmd > DEF_CHOICE) {
-        OutputGSV(p1, *state, "action");
-        do {
-            std::cout << "You have " << currPlayer->GetActions()
-                  << " action(s) remaining." << std::endl;
-            hand.PrintPileAsHand();
-            std::cout << "response?" << std::endl;
-            std::string card_name;
-            std::cin >> card_name;
-            if(card_name == "-1") {
-              cmd = DEF_CHOICE;
-            } else {
-              cmd = BAD_CHOICE;
-              for(int i = 0; i < hand.Size(); i++) {
-                if(currPlayer->GetHand().At(i)->GetName() == card_name) {
-                  cmd = i;
-                }
-              }
-            }
-        } while (cmd == BAD_CHOICE);
+        // With no action to play, ending the phase is all that's left
+        if(state->autoResolve &&
+           decision::KindsIn(hand, lookup::ACTION_CARDS) == 0) {
+            break;
+        }
+        if(decision::WantsPrompt(*state, p1)) {
+            OutputGSV(p1, *state, "action");
+        }
+        cmd = co_await decision::FromHand(*state, p1, DEC_PLAY_ACTION, hand,
+                                          lookup::ACTION_CARDS, true);
         if(cmd > DEF_CHOICE) {
-            CardType type = currPlayer->GetHand().At(cmd)->GetType();
-            if(type == ACTION || type == ATTACK || type == REACTION) {
-              Card *cardPlayed = currPlayer->HandPtr()->DrawAt(cmd);
+            const Card &card = lookup::GetCard(hand.At(cmd));
+            CardType type = card.GetType();
+            if(card.IsAction()) {
+              CardId cardPlayed = currPlayer->HandPtr()->DrawAt(cmd);
                 currPlayer->AddActions(-1);
                 game_state::HandleCardAdditions(currPlayer,
                                                 cardPlayed);
@@ -342,26 +449,26 @@ void game_state::ActionPhase(struct stateBlock *state, bool p1) {
                 if(type == ATTACK) {
                     // Check for moat before applying attack effects
                     if(!CheckMoat(otherPlayer->GetHand())) {
-                        if(cardPlayed->GetEffect() != NULL) {
-                            trashedSelf = cardPlayed->PlayEffect(state, p1);
+                        if(card.GetEffect() != NULL) {
+                            trashedSelf = co_await card.PlayEffect(state,
+                                                                   p1);
                         }
                     } else {
                         SetColor(PURPLE);
-                        std::cout << "Foe's moat nullfies your attack"
-                                  << " effect!" << std::endl;
+                        Out() << "Foe's moat nullfies your attack"
+                              << " effect!" << std::endl;
                         SetColor(WHITE);
                     }
                 } else {
                     // Handle the card's effect
-                    if(cardPlayed->GetEffect() != NULL) {
-                        trashedSelf = cardPlayed->PlayEffect(state, p1);
+                    if(card.GetEffect() != NULL) {
+                        trashedSelf = co_await card.PlayEffect(state, p1);
                     }
                 }
                 // Trash the card if it trashes itself,
                 // else discard the card
                 game_state::ActionPhaseCleanup(currPlayer, state->trash,
                                                cardPlayed, trashedSelf);
-                hand = currPlayer->GetHand();
             }
         }
     }
@@ -371,104 +478,68 @@ void game_state::ActionPhase(struct stateBlock *state, bool p1) {
     // lookup::ClearCinError();
 }
 
-void game_state::TreasurePhase(struct stateBlock *state, bool p1) {
+Task<> game_state::TreasurePhase(struct stateBlock *state, bool p1) {
     Player *currPlayer = p1 ? state->p1 : state->p2;
-    Pile hand = currPlayer->GetHand();
+    const Pile &hand = currPlayer->GetHand();
     int cmd;
     // system(CLEAR); // Clear the console
     game_state::SetColor(YELLOW);
-    std::cout << "Treasure phase: choose card(s) to play "
-              << "(or -1 to skip phase):" << std::endl;
+    Out() << "Treasure phase: choose card(s) to play "
+          << "(or -1 to skip phase):" << std::endl;
     game_state::ResetColor();
-    do {
-        OutputGSV(p1, *state, "treasure");
-        do {
-            std::cout << "You have " << currPlayer->GetCoins()
-                    << " coins(s)." << std::endl;
-            std::cout << "Hand:" << std::endl;
-            for(size_t i = 0; i < hand.Size(); i++) {
-                game_state::SetColorByType(hand.At(i)->GetType());
-                std::cout << i << ": " << hand.At(i)->ToString() << std::endl;
+    if(state->autoTreasures) {
+        // Back to front, so discarding doesn't move what's left to check
+        for(int i = (int)hand.Size() - 1; i >= 0; i--) {
+            if(lookup::TREASURE_CARDS & CARD_BIT(hand.At(i))) {
+                currPlayer->AddCoins(lookup::GetCard(hand.At(i)).GetCoins());
+                currPlayer->DiscardCard(i);
             }
-            std::cout << "response?" << std::endl;
-            game_state::ResetColor();
-            std::string card_name;
-            std::cin >> card_name;
-            std::cout << "testing1" << std::endl;
-            if(card_name == "-1") {
-              cmd = DEF_CHOICE;
-            } else {
-              cmd = BAD_CHOICE;
-              for(int i = 0; i < hand.Size(); i++) {
-                if(currPlayer->GetHand().At(i)->GetName() == card_name) {
-                  cmd = i;
-                }
-              }
-            }
-        } while (cmd == BAD_CHOICE);
+        }
+        co_return;
+    }
+    do {
+        if(state->autoResolve &&
+           decision::KindsIn(hand, lookup::TREASURE_CARDS) == 0) {
+            break;
+        }
+        if(decision::WantsPrompt(*state, p1)) {
+            OutputGSV(p1, *state, "treasure");
+        }
+        cmd = co_await decision::FromHand(*state, p1, DEC_PLAY_TREASURE,
+                                          hand, lookup::TREASURE_CARDS,
+                                          true);
 
-        if(cmd != DEF_CHOICE &&
-          currPlayer->GetHand().At(cmd)->GetType() == TREASURE_C) {
+        if(cmd != DEF_CHOICE) {
             // If a card is a treasure card, add its +coins
-            Card *cardPlayed = currPlayer->GetHand().At(cmd);
-            currPlayer->AddCoins(cardPlayed->GetCoins());
+            const Card &cardPlayed = lookup::GetCard(hand.At(cmd));
+            currPlayer->AddCoins(cardPlayed.GetCoins());
             // and then discard it.
             currPlayer->DiscardCard(cmd);
-            hand = currPlayer->GetHand();
         }
     } while(cmd != DEF_CHOICE);
 }
 
-void game_state::BuyPhase(struct stateBlock *state, bool p1) {
+Task<> game_state::BuyPhase(struct stateBlock *state, bool p1) {
     Player *currPlayer = p1 ? state->p1 : state->p2;
     int idx;
     // system(CLEAR); // Clear the console
     game_state::SetColor(BROWN);
-    std::cout << "Buy phase: choose card(s) to buy "
-              << "(or -1 to skip phase):" << std::endl;
+    Out() << "Buy phase: choose card(s) to buy "
+          << "(or -1 to skip phase):" << std::endl;
     game_state::ResetColor();
     do {
-      OutputGSV(p1, *state, "buy");
-        do{
-            std::cout << "Buyable cards:" << std::endl;
-            for(size_t i = 0; i < state->kingdom->size(); i++) {
-                game_state::SetColorByType(state->kingdom->at(i).GetTopCard()->GetType());
-                std::cout << "Card " << i << ": "
-                          << state->kingdom->at(i).GetTopCard()->ToString()
-                          << "   ";
-                if((i+1) % 5 == 0) {
-                    std::cout << std::endl;
-                }
-            }
-            game_state::ResetColor();
-            std::cout << "\nYou have " << currPlayer->GetCoins()
-                      << " coins(s) and " << currPlayer->GetBuys()
-                      << " buy(s) remaining." << std::endl;
-            std:: cout << "Type a card's number to buy it." << std::endl;
-            std::string card_name;
-            std::cin >> card_name;
-            if(card_name == "-1") {
-              idx = DEF_CHOICE;
-            } else {
-              idx = -2;
-              for(int i = 0; i < state->kingdom->size(); i++) {
-                if(card_name == state->kingdom->at(i).GetTopCard()->GetName()) {
-                  idx = i;
-                }
-              }
-            }
-        } while(idx == -2);
-        // Buy a card if it costs <= currPlayer's coins.
-        if(idx == DEF_CHOICE) {}
-        else if (state->kingdom->at(idx).GetTopCard()->GetCost() <=
-                currPlayer->GetCoins()) {
-            currPlayer->AddCoins(-1*state->kingdom->at(idx).GetTopCard()->
-                                   GetCost());
-            state->kingdom->at(idx).Move(0, currPlayer->DiscardPtr());
+        if(decision::WantsPrompt(*state, p1)) {
+            OutputGSV(p1, *state, "buy");
+        }
+        idx = co_await decision::FromSupply(*state, p1, DEC_BUY, ALL_CARDS,
+                                            currPlayer->GetCoins(), true);
+        // Only cards with one left costing <= currPlayer's coins come back
+        if(idx != DEF_CHOICE) {
+            currPlayer->AddCoins(-1*lookup::GetCard(
+                                   state->kingdom->At(idx).GetTopCard())
+                                   .GetCost());
+            state->kingdom->Take(idx, currPlayer->DiscardPtr());
             currPlayer->AddBuys(-1);
-        } else {
-            std::cout << "You don't have enough coins to buy that!"
-                      << std::endl;
         }
     } while(idx != DEF_CHOICE && currPlayer->GetBuys() > 0);
 }
@@ -477,10 +548,10 @@ void game_state::CleanupPhase(struct stateBlock *state, bool p1) {
     // system(CLEAR); // Clear the console
     Player *currPlayer = p1 ? state->p1 : state->p2;
     game_state::SetColor(LIGHT_PURPLE);
-    std::cout << "Cleanup phase: all cards in-hand and in-play "
-              << "discarded" << std::endl;
+    Out() << "Cleanup phase: all cards in-hand and in-play "
+          << "discarded" << std::endl;
     game_state::ResetColor();
-    currPlayer->DiscardPtr()->TakeAllFrom(currPlayer->HandPtr());
+    currPlayer->DiscardAll();
     // std::cout << "Drawing 5 new cards..." << std::endl;
     // std::cout << "Type \"OK\" to pass to your opponent." << std::endl;
     // char pause;
@@ -490,14 +561,13 @@ void game_state::CleanupPhase(struct stateBlock *state, bool p1) {
     currPlayer->SetNewTurn();
 }
 
-int game_state::ScoreDeck(Pile playerPile) {
+int game_state::ScoreDeck(const Pile &playerPile) {
     int score = 0;
-    std::vector<Card *> deck = playerPile.GetCards();
-    for(size_t i = 0; i < deck.size(); i++) {
-        if(deck.at(i)->GetName() == "gardens") {
-            score += ScoreGardens(deck.size());
+    for(CardId card = 0; card < NUM_CARDS; card++) {
+        if(card == CARD_GARDENS) {
+            score += playerPile.Count(card) * ScoreGardens(playerPile.Size());
         } else {
-            score += deck.at(i)->GetPoints();
+            score += playerPile.Count(card) * lookup::GetCard(card).GetPoints();
         }
     }
     return score;
@@ -507,85 +577,68 @@ int game_state::ScoreGardens(int numCards) {
     return numCards / SCORE_GARDEN;
 }
 
-bool game_state::GameOver(std::vector<Pile> &kingdomCards) {
+bool game_state::GameOver(const Supply &kingdomCards) {
     // system(CLEAR); // Clear the console
-    int numEmpty = 0;
-    for(size_t i = 0; i < kingdomCards.size(); i++) {
-        if(kingdomCards.at(i).Size() == 0) {
-            numEmpty += 1;
-        }
-        if(kingdomCards.at(i).GetName() == "province" &&
-           kingdomCards.at(i).Size() == 0) {
-            return true;
-        }
-    }
-    return numEmpty >= MAX_NUM_EMPTY;
+    return kingdomCards.ProvincesGone() ||
+           kingdomCards.GetNumEmpty() >= MAX_NUM_EMPTY;
 }
 
-bool game_state::CheckMoat(Pile otherHand) {
-    return otherHand.LookThrough(new Card(lookup::moat)) > -1;
+bool game_state::CheckMoat(const Pile &otherHand) {
+    return otherHand.Contains(CARD_MOAT);
 }
 
 void game_state::PromptActionPhase(void) {
     SetColor(GREEN);
-    std::cout << "Action phase: choose card(s) to play "
-              << "(or -1 to skip phase):" << std::endl;
+    Out() << "Action phase: choose card(s) to play "
+          << "(or -1 to skip phase):" << std::endl;
     SetColor(WHITE);
 }
 
-void game_state::HandleCardAdditions(Player *player, Card *cardPlayed) {
-    //ActionCard tmp = static_cast<ActionCard>(*cardPlayed);
+void game_state::HandleCardAdditions(Player *player, CardId cardPlayed) {
+    const Card &card = lookup::GetCard(cardPlayed);
     // Add the card's +actions
-    player->AddActions(cardPlayed->GetActions());
+    player->AddActions(card.GetActions());
     // Add the card's +buys
-    player->AddBuys(cardPlayed->GetBuys());
+    player->AddBuys(card.GetBuys());
     // Add the card's +cards
-    for(int i = 0; i < cardPlayed->GetCards(); i++) {
-        player->DrawCard();
-    }
+    player->DrawN(card.GetCards());
     // Add the card's +coins
-    player->AddCoins(cardPlayed->GetCoins());
+    player->AddCoins(card.GetCoins());
 }
 
 void game_state::ActionPhaseCleanup(Player *player, Pile *trash,
-                                    Card *cardPlayed, bool trashedSelf) {
+                                    CardId cardPlayed, bool trashedSelf) {
     if(trashedSelf) {
         trash->TopDeck(cardPlayed);
     } else {
-        player->AddToDiscard(cardPlayed);
+        // It stays in play until cleanup, so this turn's draws can't
+        // shuffle it back into the deck
+        player->AddToInPlay(cardPlayed);
     }
 }
 
 void game_state::ListRules(void) {
     char pause;
-    std::cout << PLOT_TEXT << std::endl
-              << PROMPT << std::endl;
+    Out() << PLOT_TEXT << std::endl
+          << PROMPT << std::endl;
     std::cin >> pause;
     lookup::ClearCinError();
-    std::cout << RULES_TEXT_1 << std::endl
-              << PROMPT << std::endl;
+    Out() << RULES_TEXT_1 << std::endl
+          << PROMPT << std::endl;
     std::cin >> pause;
     lookup::ClearCinError();
-    std::cout << RULES_TEXT_2 << std::endl
-              << PROMPT << std::endl;
+    Out() << RULES_TEXT_2 << std::endl
+          << PROMPT << std::endl;
 }
 
 void game_state::SetDemoCards(struct stateBlock *state) {
-    Card *tmpCard = new Card(lookup::village);
-    state->p1->AddToHand(tmpCard);
-    tmpCard = new Card(lookup::mine);
-    state->p1->AddToHand(tmpCard);
-    tmpCard = new Card(lookup::militia);
-    state->p1->AddToHand(tmpCard);
-    tmpCard = new Card(lookup::gold);
-    state->p1->AddToHand(tmpCard);
-
-    tmpCard = new Card(lookup::moneylender);
-    state->p2->AddToHand(tmpCard);
-    tmpCard = new Card(lookup::market);
-    state->p2->AddToHand(tmpCard);
-    tmpCard = new Card(lookup::moat);
-    state->p2->AddToHand(tmpCard);
-    tmpCard = new Card(lookup::gold);
-    state->p2->AddToHand(tmpCard);
+    state->p1->AddToHand(CARD_VILLAGE);
+    state->p1->AddToHand(CARD_MINE);
+    state->p1->AddToHand(CARD_MILITIA);
+    state->p1->AddToHand(CARD_GOLD);
+
+    state->p2->AddToHand(CARD_MONEYLENDER);
+    state->p2->AddToHand(CARD_MARKET);
+    state->p2->AddToHand(CARD_MOAT);
+    state->p2->AddToHand(CARD_GOLD);
 }
@@ -9,14 +9,18 @@
 #ifndef __GAME_STATE_H__
 #define __GAME_STATE_H__
 
+#include <cstdint>
+#include <ostream>
+#include <string>
 #include <vector>
 
 #include "Card.h"
-#include "ActionCard.h"
 #include "Pile.h"
-#include "TreasureCard.h"
-#include "VictoryCard.h"
+#include "SupplyPile.h"
+#include "Supply.h"
 #include "Player.h"
+#include "RandUtils.h"
+#include "Task.h"
 
 #define KINGDOM_SIZE 10
 #define PILE_SIZE 10
@@ -39,25 +43,114 @@
 
 #define CLEAR "clear"
 
+// Typed at any prompt to have the full GSV sent again
+#define RESYNC_CMD "resync"
+// Typed at any prompt to have the GSV sent when it is lazy
+#define STATE_CMD "state?"
+
+// Zones and counters a GSV reports, in the order it reports them
+#define GSV_ZONES    5
+#define GSV_COUNTERS 5
+
+class DecisionProvider;
+class PlayerClock;
+
+// Remembers the last GSV sent to one player. In delta mode only the
+// first GSV of each turn, and any the agent asks for with RESYNC_CMD,
+// are sent in full; the rest list just the counters and card counts
+// that changed since the one before. Every GSV in delta mode carries a
+// sequence number, so an agent that misses one sees a gap. In lazy
+// mode nothing is sent until the agent asks with STATE_CMD.
+class GsvLog {
+    private:
+        bool m_delta;
+        bool m_lazy;
+        bool m_sendFull;
+        uint32_t m_seq;
+        int m_counters[GSV_COUNTERS];
+        std::string m_phase;
+        uint16_t m_zones[GSV_ZONES][NUM_CARDS];
+    public:
+        GsvLog(void);
+        // Switches between full GSVs every time (the default) and deltas
+        void SetDelta(bool delta);
+        bool IsDelta(void) const { return m_delta; }
+        // Switches between a GSV at every prompt (the default) and one
+        // only when asked for
+        void SetLazy(bool lazy) { m_lazy = lazy; }
+        bool IsLazy(void) const { return m_lazy; }
+        // Makes the next GSV a full one
+        void Resync(void) { m_sendFull = true; }
+        // Returns the next GSV for player 1 or 2, and remembers it
+        std::string Next(const struct stateBlock &state, bool p1,
+                         const std::string &phase);
+};
+
+// Shared game state handed to every phase and card effect
+struct stateBlock{
+    Player *p1;
+    Player *p2;
+    Pile *trash;
+    Supply *kingdom;
+    // Who answers each player's choices; NULL asks over stdin/stdout
+    DecisionProvider *p1Decider = NULL;
+    DecisionProvider *p2Decider = NULL;
+    // What each player has been sent; NULL sends full GSVs
+    GsvLog *p1Gsv = NULL;
+    GsvLog *p2Gsv = NULL;
+    // Answers, without asking, any question with just one legal outcome:
+    // declining when nothing else is legal, the only kind of card when
+    // declining isn't allowed, or identical copies of one kind
+    bool autoResolve = false;
+    // Plays every treasure in hand instead of asking for each
+    bool autoTreasures = false;
+    // Each player's time control; NULL lets them take as long as they like
+    PlayerClock *p1Clock = NULL;
+    PlayerClock *p2Clock = NULL;
+    // Scratch the card effects reuse for picks and set-aside cards, so
+    // playing a card doesn't allocate; NULL has them use their own
+    std::vector<int> *picks = NULL;
+    Pile *setAside = NULL;
+};
+
 namespace game_state {
+    // Human-facing text (colors, prompts, card listings) goes to this
+    // thread's output sink, std::cout by default. A NULL sink makes the
+    // thread headless: the text is dropped and the bigger listings are
+    // never formatted. The GSV and "response?" lines are what agents
+    // parse, so they always go to std::cout.
+    void SetOutput(std::ostream *sink);
+    std::ostream &Out(void);
+    bool IsHeadless(void);
     void SetColor(const char color[]);
     void SetColorByType(CardType type);
     void ResetColor(void);
     int SplashScreen(void);
-    std::vector<Card> RandomizeKingdom(std::vector<Card> cardSet);
-    std::vector<Pile> GenerateKingdom(std::vector<Card> cardSet);
-    void ActionPhase(struct stateBlock *state, bool p1);
-    void TreasurePhase(struct stateBlock *state, bool p1);
-    void BuyPhase(struct stateBlock *state, bool p1);
+    std::vector<CardId> RandomizeKingdom(std::vector<CardId> cardSet,
+                        rand_utils::Rng *rng = rand_utils::DefaultRng());
+    Supply GenerateKingdom(std::vector<CardId> cardSet,
+                        rand_utils::Rng *rng = rand_utils::DefaultRng());
+    // Sends player 1 or 2 the next GSV for `phase` right away, even a
+    // lazy one
+    void SendGSV(const struct stateBlock &state, bool p1,
+                 std::string phase);
+    // Sends player 1 or 2 a full GSV for `phase` right away
+    void ResendGSV(const struct stateBlock &state, bool p1,
+                   std::string phase);
+    // The phases that ask the player anything await each answer (see
+    // Task), so a game can be left suspended in them
+    Task<> ActionPhase(struct stateBlock *state, bool p1);
+    Task<> TreasurePhase(struct stateBlock *state, bool p1);
+    Task<> BuyPhase(struct stateBlock *state, bool p1);
     void CleanupPhase(struct stateBlock *state, bool p1);
-    int ScoreDeck(Pile playerPile);
+    int ScoreDeck(const Pile &playerPile);
     int ScoreGardens(int numCards);
-    bool GameOver(std::vector<Pile> &kingdomCards);
-    bool CheckMoat(Pile otherHand);
+    bool GameOver(const Supply &kingdomCards);
+    bool CheckMoat(const Pile &otherHand);
     void PromptActionPhase(void);
     void ActionPhaseCleanup(Player *player, Pile *trash,
-                            Card *cardPlayed, bool trashedSelf);
-    void HandleCardAdditions(Player *player, Card *cardPlayed);
+                            CardId cardPlayed, bool trashedSelf);
+    void HandleCardAdditions(Player *player, CardId cardPlayed);
     void ListRules(void);
     void SetDemoCards(struct stateBlock *state);
 }
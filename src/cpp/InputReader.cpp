@@ -0,0 +1,137 @@
+/* DOMINION
+ * David Mally, Richard Roberts
+ * InputReader.cpp
+ * Defines InputReader class. Words are handed out in place, so reading
+ * and parsing an answer never allocates.
+ */
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <poll.h>
+#include <string_view>
+#include <unistd.h>
+
+#include "InputReader.h"
+
+namespace {
+    bool IsSpace(char c) {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' ||
+               c == '\v' || c == '\f';
+    }
+}
+
+InputReader::InputReader(int fd)
+    : m_fd(fd), m_pos(0), m_end(0), m_eof(false), m_hasDeadline(false),
+      m_timedOut(false) {}
+
+bool InputReader::Fill(void) {
+    if(m_eof) {
+        return false;
+    }
+    memmove(m_buf, m_buf + m_pos, m_end - m_pos);
+    m_end -= m_pos;
+    m_pos = 0;
+    while(m_end < INPUT_BUFFER_BYTES) {
+        if(m_hasDeadline) {
+            // Round up, so poll never returns early with nothing to read
+            auto left = std::chrono::ceil<std::chrono::milliseconds>(
+                m_deadline - std::chrono::steady_clock::now());
+            struct pollfd ready = {m_fd, POLLIN, 0};
+            int waitMs = left.count() > 0 ? (int)left.count() : 0;
+            int polled = poll(&ready, 1, waitMs);
+            if(polled == 0) {
+                m_timedOut = true;
+                return false;
+            } else if(polled < 0 && errno == EINTR) {
+                continue;
+            }
+        }
+        ssize_t got = read(m_fd, m_buf + m_end, INPUT_BUFFER_BYTES - m_end);
+        if(got > 0) {
+            m_end += got;
+            return true;
+        } else if(got == 0 || errno != EINTR) {
+            m_eof = true;
+            return false;
+        }
+    }
+    return false;
+}
+
+std::string_view InputReader::NextToken(void) {
+    while(true) {
+        while(m_pos < m_end && IsSpace(m_buf[m_pos])) {
+            m_pos++;
+        }
+        if(m_pos < m_end || !Fill()) {
+            break;
+        }
+    }
+    // Scan from where the word starts, reading more if it runs into the
+    // end of the buffer; a word as long as the buffer is cut there
+    size_t len = 0;
+    while(true) {
+        while(m_pos + len < m_end && !IsSpace(m_buf[m_pos + len])) {
+            len++;
+        }
+        if(m_pos + len < m_end || !Fill()) {
+            break;
+        }
+    }
+    std::string_view token(m_buf + m_pos, len);
+    m_pos += len;
+    return token;
+}
+
+bool InputReader::EndOfLine(void) {
+    while(true) {
+        while(m_pos < m_end && m_buf[m_pos] != '\n' && IsSpace(m_buf[m_pos])) {
+            m_pos++;
+        }
+        if(m_pos < m_end) {
+            if(m_buf[m_pos] == '\n') {
+                m_pos++;
+                return true;
+            }
+            return false;
+        }
+        if(!Fill()) {
+            return true;
+        }
+    }
+}
+
+bool InputReader::HasQueued(void) {
+    while(m_pos < m_end && IsSpace(m_buf[m_pos])) {
+        m_pos++;
+    }
+    return m_pos < m_end;
+}
+
+void InputReader::SetDeadline(
+    std::chrono::steady_clock::time_point deadline) {
+    m_hasDeadline = true;
+    m_timedOut = false;
+    m_deadline = deadline;
+}
+
+void InputReader::ClearDeadline(void) {
+    m_hasDeadline = false;
+    m_timedOut = false;
+}
+
+bool InputReader::TimedOut(void) const {
+    return m_timedOut;
+}
+
+bool InputReader::AtEnd(void) const {
+    return m_eof && m_pos == m_end;
+}
+
+bool InputReader::ParseInt(std::string_view token, long *value) {
+    const char *end = token.data() + token.size();
+    std::from_chars_result result = std::from_chars(token.data(), end,
+                                                    *value);
+    return !token.empty() && result.ec == std::errc() && result.ptr == end;
+}
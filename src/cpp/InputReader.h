@@ -0,0 +1,63 @@
+/* DOMINION
+ * David Mally, Richard Roberts
+ * InputReader.h
+ * Declares InputReader class, a buffered word reader on a raw file
+ * descriptor that the stdin decision provider reads answers through.
+ */
+#ifndef __INPUT_READER_H__
+#define __INPUT_READER_H__
+
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+
+// Bytes read from the descriptor at a time; also the longest word kept
+#define INPUT_BUFFER_BYTES 65536
+
+class InputReader {
+    private:
+        int m_fd;
+        char m_buf[INPUT_BUFFER_BYTES];
+        size_t m_pos;
+        size_t m_end;
+        bool m_eof;
+        bool m_hasDeadline;
+        bool m_timedOut;
+        std::chrono::steady_clock::time_point m_deadline;
+        // Moves unread bytes to the front and reads more after them.
+        // Returns false if nothing more came, or nothing came by the
+        // deadline.
+        bool Fill(void);
+    public:
+        // Reads from `fd`, which it doesn't own
+        explicit InputReader(int fd);
+        InputReader(const InputReader &other) = delete;
+        InputReader &operator=(const InputReader &other) = delete;
+        // Returns the next whitespace-separated word, or an empty one
+        // once input has run out. The word points into the reader's
+        // buffer and stays valid until the next call.
+        std::string_view NextToken(void);
+        // Skips spaces and tabs, then returns true (moving past it) if the
+        // line ends there or input has run out. For answers that are a
+        // whole line of words.
+        bool EndOfLine(void);
+        // Whether the next word has already arrived, so NextToken won't
+        // wait for input. Never reads.
+        bool HasQueued(void);
+        // Stops waiting for input at `deadline`: a read that would wait
+        // past it comes back empty instead, and TimedOut() says why.
+        // Input that has already arrived is still read.
+        void SetDeadline(std::chrono::steady_clock::time_point deadline);
+        // Waits for input as long as it takes again
+        void ClearDeadline(void);
+        // Whether a read has come back empty because the deadline passed
+        // since it was last set or cleared
+        bool TimedOut(void) const;
+        // Whether input has run out for good: the other end is closed and
+        // everything it sent has been read
+        bool AtEnd(void) const;
+        // Parses all of `token` as a base-10 integer
+        static bool ParseInt(std::string_view token, long *value);
+};
+
+#endif
@@ -15,94 +15,181 @@
 #include "CardLookup.h"
 #include "GameState.h"
 
-Pile::Pile(Owner owner, Card cardType, int size, std::string name) {
+Pile::Pile(Owner owner, CardId cardType, int size, std::string name) {
     m_owner = owner;
-    m_cards = std::vector<Card *>(size, new Card(cardType));
+    m_cards = std::vector<CardId>(size, cardType);
+    m_numUnordered = 0;
+    m_rng = NULL;
+    for(int i = 0; i < NUM_CARDS; i++) {
+        m_counts[i] = 0;
+    }
+    if(cardType < NUM_CARDS) {
+        m_counts[cardType] = size;
+    }
     m_name = name;
 }
 
-size_t Pile::Size(void) {
+void Pile::SettleFrom(size_t idx) const {
+    // Fisher-Yates run from the top down, one slot at a time: the highest
+    // unordered slot gets a uniform pick from the slots still unordered
+    while(m_numUnordered > idx) {
+        size_t last = m_numUnordered - 1;
+        size_t j = m_rng->Below(m_numUnordered);
+        CardId tmpCard = m_cards[last];
+        m_cards[last] = m_cards[j];
+        m_cards[j] = tmpCard;
+        m_numUnordered--;
+    }
+}
+
+size_t Pile::Size(void) const {
     return m_cards.size();
 }
 
-Owner Pile::GetOwner(void) {
+Owner Pile::GetOwner(void) const {
     return m_owner;
 }
 
-std::string Pile::GetName(void) {
+std::string Pile::GetName(void) const {
     return m_name;
 }
 
-std::vector<Card *> Pile::GetCards(void) {
+const std::vector<CardId> &Pile::GetCards(void) const {
+    SettleFrom(0);
     return m_cards;
 }
 
-Card *Pile::At(int idx) {
+CardId Pile::At(int idx) const {
+    SettleFrom(idx);
     return m_cards.at(idx);
 }
 
-Card *Pile::DrawAt(int idx) {
-    Card *tmpCard = m_cards.at(idx);
+CardId Pile::DrawAt(int idx) {
+    SettleFrom(idx);
+    CardId tmpCard = m_cards.at(idx);
     m_cards.erase(m_cards.begin() + idx);
+    CountOut(tmpCard);
     return tmpCard;
 }
 
 void Pile::EmptyDeck(void) {
     m_cards.clear();
+    m_numUnordered = 0;
+    for(int i = 0; i < NUM_CARDS; i++) {
+        m_counts[i] = 0;
+    }
 }
 
-Card *Pile::GetTopCard(void) {
+void Pile::Reserve(size_t size) {
+    m_cards.reserve(size);
+}
+
+CardId Pile::GetTopCard(void) const {
+    SettleFrom(m_cards.size() - 1);
     return m_cards.at(m_cards.size() - 1);
 }
 
-Card *Pile::DrawTopCard(void) {
+CardId Pile::DrawTopCard(void) {
     if(m_cards.size() > DEF_SIZE) {
-        Card *tmpCard = m_cards.at(m_cards.size() - 1);
-        m_cards.erase(m_cards.begin() + m_cards.size() - 1);
+        SettleFrom(m_cards.size() - 1);
+        CardId tmpCard = m_cards.back();
+        m_cards.pop_back();
+        CountOut(tmpCard);
         return tmpCard;
     } else {
-        return NULL;
+        return NO_CARD;
     }
 }
 
-void Pile::TopDeck(Card *card) {
+void Pile::TopDeck(CardId card) {
     m_cards.push_back(card);
+    CountIn(card);
 }
 
-int Pile::LookThrough(Card *card) {
+int Pile::LookThrough(CardId card) const {
+    if(!Contains(card)) {
+        return CARD_NOT_FOUND;
+    }
+    SettleFrom(0);
     for(size_t i = 0; i < m_cards.size(); i++) {
-        if(m_cards.at(i)->GetName() == card->GetName()) {
+        if(m_cards.at(i) == card) {
             return i;
         }
     }
     return CARD_NOT_FOUND;
 }
 
-void Pile::TrueShuffle(void) {
+void Pile::TrueShuffle(rand_utils::Rng *rng) {
     if(m_cards.size() == DEF_SIZE) { return; }
-    std::vector<int> shuffledIdxs = rand_utils::GenPseudoRandList(m_cards.size(), m_cards.size(), rand());
-    for(size_t i = 0; i < m_cards.size(); i++) {
-        Card *tmpCard = m_cards.at(i);
-        m_cards.at(i) = m_cards.at(shuffledIdxs.at(i));
-        m_cards.at(shuffledIdxs.at(i)) = tmpCard;
+    // Fisher-Yates: in place, O(n), and every ordering equally likely
+    for(size_t i = m_cards.size() - 1; i > 0; i--) {
+        size_t j = rng->Below(i + 1);
+        CardId tmpCard = m_cards[i];
+        m_cards[i] = m_cards[j];
+        m_cards[j] = tmpCard;
+    }
+    m_numUnordered = 0;
+}
+
+void Pile::LazyShuffle(rand_utils::Rng *rng) {
+    m_rng = rng;
+    m_numUnordered = m_cards.size();
+}
+
+void Pile::AddCounts(const Pile &other) {
+    for(int i = 0; i < NUM_CARDS; i++) {
+        m_counts[i] += other.m_counts[i];
     }
 }
 
 void Pile::TakeAllFrom(Pile *other) {
     // Note that other shouldn't be a reference here because
     // we're actually modifying it
-    std::vector<Card *> otherCards = other->GetCards();
-    for(size_t i = 0; i < otherCards.size(); i++) {
-        m_cards.push_back(otherCards.at(i));
-    }
+    const std::vector<CardId> &otherCards = other->GetCards();
+    m_cards.insert(m_cards.end(), otherCards.begin(), otherCards.end());
+    AddCounts(*other);
     other->EmptyDeck();
 }
 
-void Pile::Move(Card *card, Pile *other) {
+void Pile::TakeAllUnder(Pile *other) {
+    // Only one unordered run is tracked, so anything still unordered here
+    // has to be fixed before it ends up on top of other's cards
+    SettleFrom(0);
+    // Don't settle `other`: its unordered run stays at the bottom
+    m_cards.insert(m_cards.begin(), other->m_cards.begin(),
+                   other->m_cards.end());
+    m_numUnordered = other->m_numUnordered;
+    m_rng = other->m_rng;
+    AddCounts(*other);
+    other->EmptyDeck();
+}
+
+void Pile::MoveTop(size_t num, Pile *other) {
+    if(num > m_cards.size()) {
+        num = m_cards.size();
+    }
+    SettleFrom(m_cards.size() - num);
+    // The top of the pile is the back of the vector, so reverse the run
+    // to match the order of repeated DrawTopCard calls
+    other->m_cards.insert(other->m_cards.end(), m_cards.rbegin(),
+                          m_cards.rbegin() + num);
+    for(size_t i = m_cards.size() - num; i < m_cards.size(); i++) {
+        CountOut(m_cards[i]);
+        other->CountIn(m_cards[i]);
+    }
+    m_cards.resize(m_cards.size() - num);
+}
+
+void Pile::MoveCard(CardId card, Pile *other) {
+    if(!Contains(card)) {
+        return;
+    }
+    SettleFrom(0);
     for(size_t i = 0; i < m_cards.size(); i++) {
-        if(m_cards.at(i)->GetName() == card->GetName()) {
-            Card *tmp = m_cards.at(i);
+        if(m_cards.at(i) == card) {
+            CardId tmp = m_cards.at(i);
             m_cards.erase(m_cards.begin() + i);
+            CountOut(tmp);
             other->TopDeck(tmp);
             return;
         }
@@ -110,26 +197,38 @@ void Pile::Move(Card *card, Pile *other) {
 }
 
 void Pile::Move(int idx, Pile *other) {
-    Card *tmp = m_cards.at(idx);
+    SettleFrom(idx);
+    CardId tmp = m_cards.at(idx);
     m_cards.erase(m_cards.begin() + idx);
+    CountOut(tmp);
     other->TopDeck(tmp);
 }
 
-void Pile::PrintPileAsKingdom(void) {
+void Pile::PrintPileAsKingdom(void) const {
+    if(game_state::IsHeadless()) {
+        return;
+    }
+    SettleFrom(0);
     for(size_t i = 0; i < m_cards.size(); i++) {
-        game_state::SetColorByType(m_cards.at(i)->GetType());
-        std::cout << "Card " << i  << ": "
-                  << m_cards.at(i)->ToString() << std::endl;
+        const Card &card = lookup::GetCard(m_cards.at(i));
+        game_state::SetColorByType(card.GetType());
+        game_state::Out() << "Card " << i  << ": "
+                          << card.ToString() << std::endl;
     }
     game_state::ResetColor();
 }
 
-void Pile::PrintPileAsHand(void) {
-    std::cout << "Hand:" << std::endl;
+void Pile::PrintPileAsHand(void) const {
+    if(game_state::IsHeadless()) {
+        return;
+    }
+    SettleFrom(0);
+    game_state::Out() << "Hand:" << std::endl;
     for(size_t i = 0; i < m_cards.size(); i++) {
-        game_state::SetColorByType(m_cards.at(i)->GetType());
-        std::cout << "Card " << i  << ": "
-                  << m_cards.at(i)->GetName() << std::endl;
+        const Card &card = lookup::GetCard(m_cards.at(i));
+        game_state::SetColorByType(card.GetType());
+        game_state::Out() << "Card " << i  << ": "
+                          << card.GetName() << std::endl;
     }
     game_state::ResetColor();
 }
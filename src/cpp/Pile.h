@@ -9,6 +9,7 @@
 
 #include <vector>
 #include "Card.h"
+#include "RandUtils.h"
 
 #define DEF_SIZE        0
 #define DEF_NAME       ""
@@ -16,6 +17,10 @@
 #define MIN_IDX         0
 #define GEN_INTS "generateIntegers"
 
+// Every card in a single game fits in one zone of this size, so zones
+// reserved to it never reallocate mid-game
+#define MAX_ZONE_SIZE 512
+
 enum Owner {
     PLAYER1,
     PLAYER2,
@@ -27,46 +32,85 @@ enum Owner {
 class Pile {
     private:
         Owner m_owner;
-        std::vector<Card *> m_cards;
+        // The bottom m_numUnordered cards are a lazily shuffled multiset:
+        // their slots are only fixed, at random, once something looks at
+        // them. Fixing a slot doesn't change what the pile means, so const
+        // readers are allowed to do it.
+        mutable std::vector<CardId> m_cards;
+        mutable size_t m_numUnordered;
+        rand_utils::Rng *m_rng;
+        // How many of each card kind are in the pile, kept up to date by
+        // every change so counting never has to scan
+        uint16_t m_counts[NUM_CARDS];
         std::string m_name;
+        void CountIn(CardId card) {
+            if(card < NUM_CARDS) { m_counts[card]++; }
+        }
+        void CountOut(CardId card) {
+            if(card < NUM_CARDS) { m_counts[card]--; }
+        }
+        // Adds `other`'s counts to this pile's, for whole-pile merges
+        void AddCounts(const Pile &other);
+        // Fixes every slot from `idx` up to the top of the pile
+        void SettleFrom(size_t idx) const;
     public:
         // Creates a pile with `size` duplicates of `cardType`
-        Pile(Owner owner = TRASH, Card cardType = Card(),
+        Pile(Owner owner = TRASH, CardId cardType = NO_CARD,
              int size = DEF_SIZE, std::string name = DEF_NAME);
         // Returns the size of m_cards
-        size_t Size(void);
+        size_t Size(void) const;
         // Returns the pile's owner
-        Owner GetOwner(void);
+        Owner GetOwner(void) const;
         // Returns the pile's name
-        std::string GetName(void);
-        // Returns the pile's card vector
-        std::vector<Card *> GetCards(void);
+        std::string GetName(void) const;
+        // Returns a read-only view of the pile's cards, bottom to top.
+        // The view stays valid (and live) for the lifetime of the pile.
+        const std::vector<CardId> &GetCards(void) const;
+        // Returns how many copies of `card` are in the pile
+        int Count(CardId card) const {
+            return card < NUM_CARDS ? m_counts[card] : 0;
+        }
+        // Returns true if the pile holds at least one `card`
+        bool Contains(CardId card) const { return Count(card) > 0; }
         // Returns m_cards.at(idx)
-        Card *At(int idx);
+        CardId At(int idx) const;
         // Returns and removes m_cards.at(idx)
-        Card *DrawAt(int idx);
-        // Emptys the pile
+        CardId DrawAt(int idx);
+        // Emptys the pile, keeping its storage for reuse
         void EmptyDeck(void);
+        // Preallocates room for `size` cards
+        void Reserve(size_t size);
         // Returns the top card on the pile without removing it
-        Card *GetTopCard(void);
-        // Returns & removes the top card on the pile
-        Card *DrawTopCard(void);
+        CardId GetTopCard(void) const;
+        // Returns & removes the top card on the pile, or NO_CARD if empty
+        CardId DrawTopCard(void);
         // Puts a card on top of the pile
-        void TopDeck(Card *card);
+        void TopDeck(CardId card);
         // Looks through the pile for a specific card
-        int LookThrough(Card *card);
-        // Shuffles the pile
-        void TrueShuffle(void);
+        int LookThrough(CardId card) const;
+        // Shuffles the pile uniformly using `rng`
+        void TrueShuffle(rand_utils::Rng *rng);
+        // Shuffles the pile without moving anything yet: each card is
+        // picked uniformly from the remaining ones using `rng` only when
+        // it is drawn or looked at. Same distribution as TrueShuffle, but
+        // cards that are never reached cost nothing.
+        void LazyShuffle(rand_utils::Rng *rng);
         // Merges `other` into this pile
         void TakeAllFrom(Pile *other);
+        // Merges `other` into the bottom of this pile. If `other` was
+        // lazily shuffled its cards stay unordered until reached.
+        void TakeAllUnder(Pile *other);
+        // Puts the top `num` cards into `other`, in the order they would
+        // arrive if drawn one at a time
+        void MoveTop(size_t num, Pile *other);
         // Puts the first instance of `card` in this pile into `other`
-        void Move(Card *card, Pile *other);
+        void MoveCard(CardId card, Pile *other);
         // Puts `pile.at(i)` into `other`
         void Move(int idx, Pile *other);
         // Prints out all cards in the pile, as Kingdom
-        void PrintPileAsKingdom(void);
+        void PrintPileAsKingdom(void) const;
         // Prints out all cards in the pile, as Hand
-        void PrintPileAsHand(void);
+        void PrintPileAsHand(void) const;
 };
 
 #endif
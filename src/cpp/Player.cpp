@@ -2,7 +2,7 @@
  * David Mally, Richard Roberts
  * Player.cpp
  * Defines Player class, which represents the player and
- * tracks several piles (hand, deck, discard), as well as
+ * tracks several piles (hand, deck, discard, in play), as well as
  * functions on said piles.
  */
 #include <cstdlib>
@@ -10,12 +10,28 @@
 #include "Player.h"
 #include "CardLookup.h"
 #include "Pile.h"
+#include "GameState.h"
 
-Player::Player(int num, std::string name) {
+Player::Player(int num, std::string name, rand_utils::Rng *rng) {
     m_name = name;
+    m_rng = rng;
+    m_lazyShuffle = false;
     m_hand = num == 1 ? Pile(PLAYER1) : Pile(PLAYER2);
     m_deck = num == 1 ? Pile(PLAYER1) : Pile(PLAYER2);
     m_discard = num == 1 ? Pile(PLAYER1) : Pile(PLAYER2);
+    m_inPlay = num == 1 ? Pile(PLAYER1) : Pile(PLAYER2);
+    m_hand.Reserve(MAX_ZONE_SIZE);
+    m_deck.Reserve(MAX_ZONE_SIZE);
+    m_discard.Reserve(MAX_ZONE_SIZE);
+    m_inPlay.Reserve(MAX_ZONE_SIZE);
+    Reset();
+}
+
+void Player::Reset(void) {
+    m_hand.EmptyDeck();
+    m_deck.EmptyDeck();
+    m_discard.EmptyDeck();
+    m_inPlay.EmptyDeck();
 
     /* Initialize actions/buys/coins */
     m_actions = BASE_ACTIONS;
@@ -24,44 +40,42 @@ Player::Player(int num, std::string name) {
 
     /* Initialize deck to 3 estates & 7 coppers */
     for(int i = 0; i < NUM_ESTATES; i++) {
-        VictoryCard *tmp = new VictoryCard(lookup::estate);
-        m_deck.TopDeck(tmp);
+        m_deck.TopDeck(CARD_ESTATE);
     }
     for(int i = 0; i < NUM_COPPERS; i++) {
-        TreasureCard *tmp = new TreasureCard(lookup::copper);
-        m_deck.TopDeck(tmp);
+        m_deck.TopDeck(CARD_COPPER);
     }
 
     /* Shuffle the deck */
-    m_deck.TrueShuffle();
+    Shuffle(&m_deck);
 
     /* Draw 5 cards */
-    for(int i = 0; i < BASE_HAND_SIZE; i++) {
-        m_deck.Move(0, &m_hand);
-    }
+    DrawN(BASE_HAND_SIZE);
 }
 
 void Player::SetNewTurn(void) {
     m_actions = BASE_ACTIONS;
     m_buys = BASE_BUYS;
     m_coins = BASE_COINS;
-    for(int i = 0; i < BASE_HAND_SIZE; i++) {
-        DrawCard();
-    }
+    DrawN(BASE_HAND_SIZE);
 }
 
-Pile Player::GetHand(void) {
+const Pile &Player::GetHand(void) const {
     return m_hand;
 }
 
-Pile Player::GetDeck(void) {
+const Pile &Player::GetDeck(void) const {
     return m_deck;
 }
 
-Pile Player::GetDiscard(void) {
+const Pile &Player::GetDiscard(void) const {
     return m_discard;
 }
 
+const Pile &Player::GetInPlay(void) const {
+    return m_inPlay;
+}
+
 Pile *Player::HandPtr(void) {
     return &m_hand;
 }
@@ -74,6 +88,10 @@ Pile *Player::DiscardPtr(void) {
     return &m_discard;
 }
 
+Pile *Player::InPlayPtr(void) {
+    return &m_inPlay;
+}
+
 std::string Player::GetName(void) {
     return m_name;
 }
@@ -90,6 +108,24 @@ int Player::GetCoins(void) {
     return m_coins;
 }
 
+int Player::GetNumCards(void) const {
+    return m_hand.Size() + m_deck.Size() + m_discard.Size() +
+           m_inPlay.Size();
+}
+
+int Player::GetScore(void) const {
+    int score = 0;
+    int numGardens = 0;
+    for(const Pile *zone : {&m_hand, &m_deck, &m_discard, &m_inPlay}) {
+        // Victory cards and curses are the only cards with points
+        for(CardId card = CARD_ESTATE; card <= CARD_CURSE; card++) {
+            score += zone->Count(card) * lookup::GetCard(card).GetPoints();
+        }
+        numGardens += zone->Count(CARD_GARDENS);
+    }
+    return score + numGardens * game_state::ScoreGardens(GetNumCards());
+}
+
 void Player::AddActions(int actions) {
     m_actions += actions;
 }
@@ -102,29 +138,49 @@ void Player::AddCoins(int coins) {
     m_coins += coins;
 }
 
-void Player::AddToHand(Card *card) {
+void Player::AddToHand(CardId card) {
     m_hand.TopDeck(card);
 }
 
-void Player::AddToDeck(Card *card) {
+void Player::AddToDeck(CardId card) {
     m_deck.TopDeck(card);
 }
 
-void Player::AddToDiscard(Card *card) {
+void Player::AddToDiscard(CardId card) {
     m_discard.TopDeck(card);
 }
 
-void Player::DrawCard(void) {
-    // If the deck runs out, put the discard pile into the deck
-    // and reshuffle
-    if(m_deck.Size() == 0) {
-        m_deck.TakeAllFrom(&m_discard);
-        m_deck.TrueShuffle();
+void Player::AddToInPlay(CardId card) {
+    m_inPlay.TopDeck(card);
+}
+
+void Player::SetLazyShuffle(bool lazy) {
+    m_lazyShuffle = lazy;
+}
+
+void Player::Shuffle(Pile *pile) {
+    if(m_lazyShuffle) {
+        pile->LazyShuffle(m_rng);
+    } else {
+        pile->TrueShuffle(m_rng);
     }
-    // If the deck isn't completely drawn out, draw a card
-    if(m_deck.Size() > 0) {
-        m_deck.Move(0, &m_hand);
+}
+
+void Player::DrawCard(void) {
+    DrawN(1);
+}
+
+void Player::DrawN(int num) {
+    if(num <= 0) { return; }
+    // If the deck can't cover the draw, reshuffle the discard pile and
+    // put it under the deck: the rest of the draw then comes from the
+    // new cards, exactly as if the deck had run out mid-draw
+    if(m_deck.Size() < (size_t)num && m_discard.Size() > 0) {
+        Shuffle(&m_discard);
+        m_deck.TakeAllUnder(&m_discard);
     }
+    // Draw from the top of the deck, where TopDeck puts cards
+    m_deck.MoveTop(num, &m_hand);
 }
 
 void Player::DiscardCard(int handIdx) {
@@ -135,6 +191,11 @@ void Player::TrashCard(int handIdx, Pile *trash) {
     m_hand.Move(handIdx, trash);
 }
 
+void Player::DiscardAll(void) {
+    m_discard.TakeAllFrom(&m_hand);
+    m_discard.TakeAllFrom(&m_inPlay);
+}
+
 void Player::PlayCard(int handIdx) {
     if((size_t)handIdx < m_hand.Size()) {
     }
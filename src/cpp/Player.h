@@ -2,7 +2,7 @@
  * David Mally, Richard Roberts
  * Player.h
  * Defines Player class, which represents the player and
- * tracks several piles (hand, deck, discard), as well as
+ * tracks several piles (hand, deck, discard, in play), as well as
  * functions on said piles.
  */
 #ifndef __PLAYER_H__
@@ -10,6 +10,7 @@
 
 #include <string>
 #include "Pile.h"
+#include "RandUtils.h"
 
 #define BASE_HAND_SIZE  5
 #define BASE_DECK_SIZE 10
@@ -26,31 +27,61 @@ class Player {
         Pile m_hand;
         Pile m_deck;
         Pile m_discard;
+        // Actions played this turn, discarded at cleanup
+        Pile m_inPlay;
         int m_actions;
         int m_buys;
         int m_coins;
+        rand_utils::Rng *m_rng;
+        bool m_lazyShuffle;
+        // Shuffles `pile` the way SetLazyShuffle asked for
+        void Shuffle(Pile *pile);
     public:
-        Player(int num = 1, std::string name = "p1");
+        // `rng` drives this player's reshuffles and must outlive them
+        Player(int num = 1, std::string name = "p1",
+               rand_utils::Rng *rng = rand_utils::DefaultRng());
+        // Returns the player to their starting deck and hand, keeping
+        // the zones' storage so a new game can reuse it
+        void Reset(void);
         void SetNewTurn(void);
-        Pile GetHand(void);
-        Pile GetDeck(void);
-        Pile GetDiscard(void);
+        // In lazy mode reshuffles only pick a card when it's drawn, which
+        // is cheaper for rollouts that stop early. The odds are the same,
+        // but a given seed deals different games in each mode.
+        void SetLazyShuffle(bool lazy);
+        // Read-only views of the player's zones; these never copy
+        const Pile &GetHand(void) const;
+        const Pile &GetDeck(void) const;
+        const Pile &GetDiscard(void) const;
+        const Pile &GetInPlay(void) const;
         Pile *HandPtr(void);
         Pile *DeckPtr(void);
         Pile *DiscardPtr(void);
+        Pile *InPlayPtr(void);
         std::string GetName(void);
         int GetActions(void);
         int GetBuys(void);
         int GetCoins(void);
+        // Returns how many cards the player owns across all zones
+        int GetNumCards(void) const;
+        // Returns the player's victory points. Both read the zones'
+        // running counts, so neither depends on how many cards there are.
+        int GetScore(void) const;
         void AddActions(int actions);
         void AddBuys(int buys);
         void AddCoins(int coins);
-        void AddToHand(Card *card);
-        void AddToDeck(Card *card);
-        void AddToDiscard(Card *card);
+        void AddToHand(CardId card);
+        void AddToDeck(CardId card);
+        void AddToDiscard(CardId card);
+        // Puts a played card in play, where draws can't reach it until
+        // cleanup discards it
+        void AddToInPlay(CardId card);
         void DrawCard(void);
+        // Draws `num` cards with at most one reshuffle
+        void DrawN(int num);
         void DiscardCard(int handIdx);
         void TrashCard(int handIdx, Pile *trash);
+        // Discards the hand and everything in play
+        void DiscardAll(void);
         void PlayCard(int handIdx);
         bool operator==(Player other);
 };
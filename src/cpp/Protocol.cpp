@@ -0,0 +1,265 @@
+/* DOMINION
+ * David Mally, Richard Roberts
+ * Protocol.cpp
+ * Defines the binary game-state protocol: one fixed-layout record per
+ * decision point, a compact binary reply, and the decision provider
+ * that speaks it over a pair of streams.
+ */
+#include <coroutine>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Protocol.h"
+#include "CardLookup.h"
+#include "GameState.h"
+
+namespace {
+    // Fields are written a byte at a time so the layout is little-endian
+    // whatever the host is
+    void Put8(std::string *frame, uint8_t value) {
+        frame->push_back((char)value);
+    }
+
+    void Put16(std::string *frame, uint16_t value) {
+        Put8(frame, value & 0xFF);
+        Put8(frame, value >> 8);
+    }
+
+    void Put32(std::string *frame, uint32_t value) {
+        Put16(frame, value & 0xFFFF);
+        Put16(frame, value >> 16);
+    }
+
+    void PutCounts(std::string *frame, const uint16_t counts[NUM_CARDS]) {
+        for(CardId card = 0; card < NUM_CARDS; card++) {
+            Put16(frame, counts[card]);
+        }
+    }
+
+    uint16_t Get16(const uint8_t *data) {
+        return data[0] | (data[1] << 8);
+    }
+
+    uint32_t Get32(const uint8_t *data) {
+        return Get16(data) | ((uint32_t)Get16(data + 2) << 16);
+    }
+
+    const uint8_t *GetCounts(const uint8_t *data, uint16_t counts[NUM_CARDS]) {
+        for(CardId card = 0; card < NUM_CARDS; card++) {
+            counts[card] = Get16(data + 2 * card);
+        }
+        return data + 2 * NUM_CARDS;
+    }
+
+    void CountPile(const Pile &pile, uint16_t counts[NUM_CARDS]) {
+        for(CardId card = 0; card < NUM_CARDS; card++) {
+            counts[card] = pile.Count(card);
+        }
+    }
+}
+
+void protocol::Snapshot(const struct stateBlock &state, bool p1,
+                        StateRecord *record) {
+    Player *player = p1 ? state.p1 : state.p2;
+    Player *other = p1 ? state.p2 : state.p1;
+    record->decision = DEC_GAME_OVER;
+    record->player = p1 ? 1 : 2;
+    record->canDecline = 0;
+    record->min = 0;
+    record->max = 0;
+    record->subject = NO_CARD;
+    record->actions = player->GetActions();
+    record->buys = player->GetBuys();
+    record->coins = player->GetCoins();
+    record->playerScore = player->GetScore();
+    record->opponentScore = other->GetScore();
+    record->maxCost = DEF_COST;
+    record->options = 0;
+    CountPile(player->GetDeck(), record->deck);
+    CountPile(player->GetHand(), record->hand);
+    CountPile(player->GetDiscard(), record->discard);
+    for(CardId card = 0; card < NUM_CARDS; card++) {
+        record->supply[card] = 0;
+    }
+    for(const SupplyPile &pile : *state.kingdom) {
+        record->supply[pile.GetTopCard()] = pile.Size();
+    }
+    CountPile(*state.trash, record->trash);
+}
+
+void protocol::Encode(const StateRecord &record, std::string *frame) {
+    Put32(frame, RECORD_BODY_SIZE);
+    Put8(frame, PROTOCOL_VERSION);
+    Put8(frame, record.decision);
+    Put8(frame, record.player);
+    Put8(frame, record.canDecline);
+    Put8(frame, record.min);
+    Put8(frame, record.max);
+    Put8(frame, record.subject);
+    Put8(frame, NUM_CARDS);
+    Put16(frame, record.actions);
+    Put16(frame, record.buys);
+    Put16(frame, record.coins);
+    Put16(frame, record.playerScore);
+    Put16(frame, record.opponentScore);
+    Put16(frame, record.maxCost);
+    Put32(frame, record.options);
+    PutCounts(frame, record.deck);
+    PutCounts(frame, record.hand);
+    PutCounts(frame, record.discard);
+    PutCounts(frame, record.supply);
+    PutCounts(frame, record.trash);
+}
+
+size_t protocol::Decode(const uint8_t *data, size_t size,
+                        StateRecord *record) {
+    if(size < 4 + RECORD_BODY_SIZE || Get32(data) != RECORD_BODY_SIZE ||
+       data[4] != PROTOCOL_VERSION || data[11] != NUM_CARDS) {
+        return 0;
+    }
+    record->decision = data[5];
+    record->player = data[6];
+    record->canDecline = data[7];
+    record->min = data[8];
+    record->max = data[9];
+    record->subject = data[10];
+    record->actions = Get16(data + 12);
+    record->buys = Get16(data + 14);
+    record->coins = Get16(data + 16);
+    record->playerScore = Get16(data + 18);
+    record->opponentScore = Get16(data + 20);
+    record->maxCost = Get16(data + 22);
+    record->options = Get32(data + 24);
+    const uint8_t *counts = data + 28;
+    counts = GetCounts(counts, record->deck);
+    counts = GetCounts(counts, record->hand);
+    counts = GetCounts(counts, record->discard);
+    counts = GetCounts(counts, record->supply);
+    GetCounts(counts, record->trash);
+    return 4 + RECORD_BODY_SIZE;
+}
+
+BinaryDecider::BinaryDecider(std::istream *in, std::ostream *out,
+                             bool suspends)
+    : m_in(in), m_out(out), m_suspends(suspends), m_sent(false),
+      m_pending(false) {
+    m_frame.reserve(4 + RECORD_BODY_SIZE);
+}
+
+void BinaryDecider::Ask(const protocol::StateRecord &record) {
+    if(!m_sent) {
+        m_frame.clear();
+        protocol::Encode(record, &m_frame);
+        m_out->write(m_frame.data(), m_frame.size());
+        m_out->flush();
+        m_sent = true;
+    }
+    m_reply.clear();
+    // in_avail() is -1 once nothing more will come, which reading finds
+    m_pending = m_suspends && m_in->rdbuf()->in_avail() == 0;
+    if(m_pending) {
+        return;
+    }
+    m_sent = false;
+    int count = m_in->get();
+    for(int i = 0; i < count && m_in->good(); i++) {
+        int value = m_in->get();
+        if(value != std::char_traits<char>::eof()) {
+            m_reply.push_back(value);
+        }
+    }
+}
+
+int BinaryDecider::ChooseFromHand(const struct stateBlock &state, bool p1,
+                                  Decision type, const Pile &hand,
+                                  CardMask options, bool canDecline) {
+    protocol::StateRecord record;
+    protocol::Snapshot(state, p1, &record);
+    record.decision = type;
+    record.canDecline = canDecline;
+    record.min = 1;
+    record.max = 1;
+    record.options = options;
+    Ask(record);
+    if(m_reply.empty()) {
+        return DEF_CHOICE;
+    }
+    return hand.LookThrough(m_reply[0]);
+}
+
+void BinaryDecider::ChooseManyFromHand(const struct stateBlock &state,
+                                       bool p1, Decision type,
+                                       const Pile &hand, CardMask options,
+                                       int min, int max,
+                                       std::vector<int> *picks) {
+    protocol::StateRecord record;
+    protocol::Snapshot(state, p1, &record);
+    record.decision = type;
+    record.canDecline = min == 0;
+    record.min = min;
+    record.max = max;
+    record.options = options;
+    Ask(record);
+    // Each id takes the next copy of that card not already picked
+    std::vector<bool> taken(hand.Size(), false);
+    for(CardId card : m_reply) {
+        for(size_t i = 0; i < hand.Size(); i++) {
+            if(!taken[i] && hand.At(i) == card) {
+                taken[i] = true;
+                picks->push_back(i);
+                break;
+            }
+        }
+    }
+}
+
+int BinaryDecider::ChooseFromSupply(const struct stateBlock &state, bool p1,
+                                    Decision type, CardMask options,
+                                    int maxCost, bool canDecline) {
+    protocol::StateRecord record;
+    protocol::Snapshot(state, p1, &record);
+    record.decision = type;
+    record.canDecline = canDecline;
+    record.min = 1;
+    record.max = 1;
+    record.maxCost = maxCost;
+    record.options = options;
+    Ask(record);
+    if(m_reply.empty()) {
+        return DEF_CHOICE;
+    }
+    return state.kingdom->IndexOf(m_reply[0]);
+}
+
+bool BinaryDecider::ChooseYesNo(const struct stateBlock &state, bool p1,
+                                Decision type, CardId card) {
+    protocol::StateRecord record;
+    protocol::Snapshot(state, p1, &record);
+    record.decision = type;
+    record.subject = card;
+    Ask(record);
+    return !m_reply.empty() && m_reply[0] != 0;
+}
+
+bool BinaryDecider::Pending(void) {
+    return m_pending;
+}
+
+void BinaryDecider::Park(std::coroutine_handle<> game) {
+    m_parked = game;
+}
+
+std::coroutine_handle<> BinaryDecider::TakeParked(void) {
+    return std::exchange(m_parked, {});
+}
+
+void BinaryDecider::GameOver(const struct stateBlock &state) {
+    protocol::StateRecord record;
+    protocol::Snapshot(state, true, &record);
+    m_frame.clear();
+    protocol::Encode(record, &m_frame);
+    m_out->write(m_frame.data(), m_frame.size());
+    m_out->flush();
+}
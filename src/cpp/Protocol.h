@@ -0,0 +1,135 @@
+/* DOMINION
+ * David Mally, Richard Roberts
+ * Protocol.h
+ * Defines the binary game-state protocol: one fixed-layout record per
+ * decision point, a compact binary reply, and the decision provider
+ * that speaks it over a pair of streams.
+ */
+#ifndef __PROTOCOL_H__
+#define __PROTOCOL_H__
+
+#include <coroutine>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Card.h"
+#include "Pile.h"
+#include "Decision.h"
+
+#define PROTOCOL_VERSION 1
+// Decision field of the record sent once the game has ended; it expects
+// no reply
+#define DEC_GAME_OVER 0xFF
+// Bytes in a record after its length prefix
+#define RECORD_BODY_SIZE (24 + 5 * 2 * NUM_CARDS)
+
+/* Every record is little-endian and laid out as:
+ *
+ *   u32 length           bytes that follow (RECORD_BODY_SIZE)
+ *   u8  version          PROTOCOL_VERSION
+ *   u8  decision         a Decision, or DEC_GAME_OVER
+ *   u8  player           1 or 2, whoever has to answer
+ *   u8  canDecline       1 if an empty reply is allowed
+ *   u8  min, max         how many cards a multi-select must/may name
+ *   u8  subject          the card a yes/no question is about, else 0xFF
+ *   u8  numCards         NUM_CARDS, the length of every count array
+ *   i16 actions, buys, coins          the deciding player's counters
+ *   i16 playerScore, opponentScore
+ *   i16 maxCost          cost limit on a supply choice, else -1
+ *   u32 options          CardMask of the legal answers
+ *   u16 deck[numCards]   the deciding player's zones, counted by CardId
+ *   u16 hand[numCards]
+ *   u16 discard[numCards]
+ *   u16 supply[numCards] cards left in each supply pile, by CardId
+ *   u16 trash[numCards]
+ *
+ * The reply is u8 count followed by count u8 values. Hand and supply
+ * choices name cards by CardId (a multi-select repeats an id to pick
+ * several copies); an empty reply declines. A yes/no reply is one value,
+ * nonzero for yes. src/python/binary_protocol.py is a reference decoder
+ * for agents. */
+namespace protocol {
+    // A decoded record
+    struct StateRecord {
+        uint8_t decision;
+        uint8_t player;
+        uint8_t canDecline;
+        uint8_t min;
+        uint8_t max;
+        CardId subject;
+        int16_t actions;
+        int16_t buys;
+        int16_t coins;
+        int16_t playerScore;
+        int16_t opponentScore;
+        int16_t maxCost;
+        CardMask options;
+        uint16_t deck[NUM_CARDS];
+        uint16_t hand[NUM_CARDS];
+        uint16_t discard[NUM_CARDS];
+        uint16_t supply[NUM_CARDS];
+        uint16_t trash[NUM_CARDS];
+    };
+
+    // Fills everything in `record` that comes from the game, as seen by
+    // player 1 or 2, and clears the question fields
+    void Snapshot(const struct stateBlock &state, bool p1,
+                  StateRecord *record);
+    // Appends `record`, length prefix included, to `frame`
+    void Encode(const StateRecord &record, std::string *frame);
+    // Reads one record from the start of `data`. Returns the bytes it
+    // used, or 0 if `data` is short or isn't a record this version reads.
+    size_t Decode(const uint8_t *data, size_t size, StateRecord *record);
+}
+
+// Answers each question by sending a record on `out` and reading the
+// reply from `in`. A reply that can't be read counts as empty, and the
+// decision:: checks turn that into a legal answer, so a dead agent ends
+// the game instead of hanging it.
+class BinaryDecider : public DecisionProvider {
+    private:
+        std::istream *m_in;
+        std::ostream *m_out;
+        bool m_suspends;
+        // Whether the record for the question being asked has gone out,
+        // so asking it again after a Pending answer doesn't resend it
+        bool m_sent;
+        bool m_pending;
+        std::coroutine_handle<> m_parked;
+        // Reused for every record and reply
+        std::string m_frame;
+        std::vector<CardId> m_reply;
+        // Sends `record` and reads the reply into m_reply
+        void Ask(const protocol::StateRecord &record);
+    public:
+        // With `suspends`, a question whose reply can't be read from `in`
+        // yet (its streambuf's in_avail() is 0) is left Pending instead of
+        // waited for, so the game is suspended until the reply arrives.
+        // The streambuf has to count the bytes it holds for that.
+        BinaryDecider(std::istream *in, std::ostream *out,
+                      bool suspends = false);
+        bool Pending(void);
+        void Park(std::coroutine_handle<> game);
+        // Returns the game parked waiting for a reply, if there is one,
+        // and forgets it
+        std::coroutine_handle<> TakeParked(void);
+        int ChooseFromHand(const struct stateBlock &state, bool p1,
+                           Decision type, const Pile &hand,
+                           CardMask options, bool canDecline);
+        void ChooseManyFromHand(const struct stateBlock &state, bool p1,
+                                Decision type, const Pile &hand,
+                                CardMask options, int min, int max,
+                                std::vector<int> *picks);
+        int ChooseFromSupply(const struct stateBlock &state, bool p1,
+                             Decision type, CardMask options,
+                             int maxCost, bool canDecline);
+        bool ChooseYesNo(const struct stateBlock &state, bool p1,
+                         Decision type, CardId card);
+        // Sends the final DEC_GAME_OVER record, as seen by player 1
+        void GameOver(const struct stateBlock &state);
+};
+
+#endif
@@ -1,31 +1,83 @@
 /* DOMINION
  * David Mally, Richard Roberts
  * RandUtils.cpp
- * Defines a function to generate a pseudorandom list of numbers.
- * Used as a fallback when we run out of API requests or are offline.
+ * Defines the seeded pseudorandom generator each game owns, and a
+ * function to generate a pseudorandom list of distinct numbers.
  */
 #include <cstdlib>
+#include <cstdint>
 #include <vector>
 #include "RandUtils.h"
 
-std::vector<int> rand_utils::GenPseudoRandList(size_t size, int max, int seed) {
-    std::vector<int> pseudoRands;
-    srand(seed);
+#define SPLITMIX_GAMMA 0x9E3779B97F4A7C15ULL
+
+rand_utils::Rng::Rng(uint64_t seed) {
+    Seed(seed);
+}
+
+rand_utils::Rng::Rng(uint64_t seed, uint64_t stream) {
+    Seed(seed, stream);
+}
+
+uint64_t rand_utils::Rng::Mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void rand_utils::Rng::Seed(uint64_t seed) {
+    // Expand the seed with splitmix64, which never yields the all-zero
+    // state xoshiro can't leave
+    for(int i = 0; i < 4; i++) {
+        seed += SPLITMIX_GAMMA;
+        m_state[i] = Mix(seed);
+    }
+}
+
+void rand_utils::Rng::Seed(uint64_t seed, uint64_t stream) {
+    // Hash the stream index before folding it in, so neighbouring games
+    // start at unrelated points of splitmix64's sequence rather than a
+    // few steps apart
+    Seed(seed ^ Mix(stream + SPLITMIX_GAMMA));
+}
+
+uint32_t rand_utils::Rng::Below(uint32_t bound) {
+    // Lemire's multiply-shift; the retry only triggers for the few
+    // values that would bias the result
+    uint64_t m = (Next() >> 32) * bound;
+    uint32_t low = (uint32_t)m;
+    if(low < bound) {
+        uint32_t threshold = -bound % bound;
+        while(low < threshold) {
+            m = (Next() >> 32) * bound;
+            low = (uint32_t)m;
+        }
+    }
+    return m >> 32;
+}
+
+rand_utils::Rng *rand_utils::DefaultRng(void) {
+    static thread_local Rng defaultRng;
+    return &defaultRng;
+}
+
+std::vector<int> rand_utils::GenPseudoRandList(size_t size, int max,
+                                               Rng *rng) {
+    // Partial Fisher-Yates shuffle of [0, size); the first `max`
+    // entries are the result
+    std::vector<int> pseudoRands(size);
+    for(size_t i = 0; i < size; i++) {
+        pseudoRands.at(i) = i;
+    }
+    if((size_t)max > size) {
+        max = size;
+    }
     for(int i = 0; i < max; i++) {
-        int randIdx = rand() % size;
-        bool notUniq = false;
-        do {
-            notUniq = false;
-            for(int j = 0; j < i; j++) {
-                if(pseudoRands.at(j) == randIdx) {
-                    notUniq = true;
-                }
-            }
-            if(notUniq) {
-                randIdx = rand() % size;
-            }
-        } while(notUniq);
-        pseudoRands.push_back(randIdx);
+        int j = i + rng->Below(size - i);
+        int tmp = pseudoRands.at(i);
+        pseudoRands.at(i) = pseudoRands.at(j);
+        pseudoRands.at(j) = tmp;
     }
+    pseudoRands.resize(max);
     return pseudoRands;
 }
@@ -1,17 +1,63 @@
 /* DOMINION
  * David Mally, Richard Roberts
  * RandUtils.h
- * Defines a function to generate a pseudorandom list of numbers.
- * Used as a fallback when we run out of API requests or are offline.
+ * Defines the seeded pseudorandom generator each game owns, and a
+ * function to generate a pseudorandom list of distinct numbers.
  */
 #ifndef __RANDUTILS_H__
 #define __RANDUTILS_H__
 
+#include <cstdint>
 #include <vector>
 #include <cstdlib>
 
+#define DEF_SEED 0x5EED
+
 namespace rand_utils {
-    std::vector<int> GenPseudoRandList(size_t size, int max, int seed);
+    // xoshiro256** generator. Small, fast, and fully determined by the
+    // seed it is given, so a game can be replayed from its seed.
+    class Rng {
+        private:
+            uint64_t m_state[4];
+        public:
+            Rng(uint64_t seed = DEF_SEED);
+            // Starts on stream `stream` of `seed` (see Seed below)
+            Rng(uint64_t seed, uint64_t stream);
+            // Restarts the sequence from `seed`
+            void Seed(uint64_t seed);
+            // Restarts on stream `stream` of `seed`. Each stream depends
+            // only on the pair, so game N of a campaign deals the same
+            // whichever thread plays it, and can be replayed on its own.
+            void Seed(uint64_t seed, uint64_t stream);
+            // Returns the next 64 random bits
+            uint64_t Next(void) {
+                uint64_t result = Rotl(m_state[1] * 5, 7) * 9;
+                uint64_t t = m_state[1] << 17;
+                m_state[2] ^= m_state[0];
+                m_state[3] ^= m_state[1];
+                m_state[1] ^= m_state[2];
+                m_state[0] ^= m_state[3];
+                m_state[2] ^= t;
+                m_state[3] = Rotl(m_state[3], 45);
+                return result;
+            }
+            // Returns a uniformly distributed number in [0, bound)
+            uint32_t Below(uint32_t bound);
+        private:
+            // splitmix64's output function
+            static uint64_t Mix(uint64_t x);
+            static uint64_t Rotl(uint64_t x, int k) {
+                return (x << k) | (x >> (64 - k));
+            }
+    };
+
+    // Generator for code that runs outside a GameArena. Each thread gets
+    // its own, so it is safe but not reproducible across thread counts;
+    // anything that needs replaying should own an Rng instead.
+    Rng *DefaultRng(void);
+
+    // Returns `max` distinct numbers drawn from [0, size)
+    std::vector<int> GenPseudoRandList(size_t size, int max, Rng *rng);
 }
 
 #endif
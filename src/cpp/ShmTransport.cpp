@@ -0,0 +1,243 @@
+/* DOMINION
+ * David Mally, Richard Roberts
+ * ShmTransport.cpp
+ * Defines the shared-memory transport: the channel each side maps, the
+ * spin-then-futex waits on its rings, and the streambuf over it.
+ */
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "ShmTransport.h"
+
+namespace {
+    long Futex(const std::atomic<uint32_t> *word, int op, uint32_t value,
+               const struct timespec *timeout) {
+        // Not FUTEX_PRIVATE_FLAG: the word is shared between processes
+        return syscall(SYS_futex, const_cast<std::atomic<uint32_t> *>(word),
+                       op, value, timeout, NULL, 0);
+    }
+
+    void Wake(const std::atomic<uint32_t> *word) {
+        Futex(word, FUTEX_WAKE, INT_MAX, NULL);
+    }
+
+    inline void CpuRelax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+}
+
+ShmChannel::ShmChannel(void) : m_engine(false), m_seg(NULL) {}
+
+ShmChannel::~ShmChannel(void) {
+    Close();
+    if(m_seg != NULL) {
+        munmap(m_seg, sizeof(ShmSegment));
+    }
+    if(m_engine) {
+        shm_unlink(m_name.c_str());
+    }
+}
+
+bool ShmChannel::Map(const std::string &name, bool create) {
+    int fd = create ? shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600)
+                    : shm_open(name.c_str(), O_RDWR, 0);
+    if(fd == -1) {
+        return false;
+    }
+    struct stat info;
+    if((create && ftruncate(fd, sizeof(ShmSegment)) == -1) ||
+       fstat(fd, &info) == -1 || (size_t)info.st_size < sizeof(ShmSegment)) {
+        close(fd);
+        if(create) {
+            shm_unlink(name.c_str());
+        }
+        return false;
+    }
+    void *mapped = mmap(NULL, sizeof(ShmSegment), PROT_READ | PROT_WRITE,
+                        MAP_SHARED, fd, 0);
+    close(fd);
+    if(mapped == MAP_FAILED) {
+        if(create) {
+            shm_unlink(name.c_str());
+        }
+        return false;
+    }
+    m_seg = (ShmSegment *)mapped;
+    m_name = name;
+    m_engine = create;
+    return true;
+}
+
+bool ShmChannel::Create(const std::string &name) {
+    // A segment left by an engine that died would make O_EXCL fail
+    shm_unlink(name.c_str());
+    if(!Map(name, true)) {
+        return false;
+    }
+    // ftruncate zero-fills, which is already two empty rings
+    m_seg->enginePid.store(getpid());
+    m_seg->magic.store(SHM_MAGIC, std::memory_order_release);
+    return true;
+}
+
+bool ShmChannel::Attach(const std::string &name) {
+    if(!Map(name, false)) {
+        return false;
+    }
+    if(m_seg->magic.load(std::memory_order_acquire) != SHM_MAGIC) {
+        munmap(m_seg, sizeof(ShmSegment));
+        m_seg = NULL;
+        return false;
+    }
+    m_seg->agentPid.store(getpid());
+    return true;
+}
+
+void ShmChannel::Close(void) {
+    if(m_seg == NULL || m_seg->closed.exchange(1) != 0) {
+        return;
+    }
+    ShmRing *rings[2] = {&m_seg->toAgent, &m_seg->toEngine};
+    for(ShmRing *ring : rings) {
+        Wake(&ring->head);
+        Wake(&ring->tail);
+    }
+}
+
+bool ShmChannel::PeerAlive(void) const {
+    if(m_seg->closed.load() != 0) {
+        return false;
+    }
+    // An agent that hasn't attached yet may still be starting up
+    pid_t peer = m_engine ? m_seg->agentPid.load() : m_seg->enginePid.load();
+    return peer == 0 || kill(peer, 0) == 0 || errno == EPERM;
+}
+
+bool ShmChannel::WaitWhile(const std::atomic<uint32_t> &index,
+                           std::atomic<uint32_t> *waiter,
+                           uint32_t value) const {
+    for(int spin = 0; spin < SHM_SPIN_LIMIT; spin++) {
+        if(index.load(std::memory_order_acquire) != value) {
+            return true;
+        }
+        CpuRelax();
+    }
+    const struct timespec timeout = {0, SHM_WAIT_NS};
+    while(true) {
+        // The other side stores the index then reads the flag, and this
+        // side stores the flag then reads the index, so (both seq_cst)
+        // one of them always sees the other
+        waiter->store(1);
+        if(index.load() == value) {
+            Futex(&index, FUTEX_WAIT, value, &timeout);
+        }
+        waiter->store(0);
+        if(index.load(std::memory_order_acquire) != value) {
+            return true;
+        }
+        if(!PeerAlive()) {
+            return false;
+        }
+    }
+}
+
+bool ShmChannel::Write(const uint8_t *data, size_t size) {
+    if(m_seg == NULL) {
+        return false;
+    }
+    ShmRing *ring = m_engine ? &m_seg->toAgent : &m_seg->toEngine;
+    uint32_t head = ring->head.load(std::memory_order_relaxed);
+    while(size > 0) {
+        uint32_t tail = ring->tail.load(std::memory_order_acquire);
+        uint32_t room = SHM_RING_BYTES - (head - tail);
+        if(room == 0) {
+            if(!WaitWhile(ring->tail, &ring->tailWaiter, tail)) {
+                return false;
+            }
+            continue;
+        }
+        size_t count = std::min((size_t)room, size);
+        size_t offset = head & (SHM_RING_BYTES - 1);
+        size_t first = std::min(count, (size_t)SHM_RING_BYTES - offset);
+        memcpy(ring->data + offset, data, first);
+        memcpy(ring->data, data + first, count - first);
+        head += count;
+        data += count;
+        size -= count;
+        ring->head.store(head);
+        if(ring->headWaiter.load() != 0) {
+            Wake(&ring->head);
+        }
+    }
+    return true;
+}
+
+size_t ShmChannel::Read(uint8_t *data, size_t size) {
+    if(m_seg == NULL || size == 0) {
+        return 0;
+    }
+    ShmRing *ring = m_engine ? &m_seg->toEngine : &m_seg->toAgent;
+    uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+    uint32_t head = ring->head.load(std::memory_order_acquire);
+    if(head == tail) {
+        if(!WaitWhile(ring->head, &ring->headWaiter, tail)) {
+            return 0;
+        }
+        head = ring->head.load(std::memory_order_acquire);
+    }
+    size_t count = std::min((size_t)(head - tail), size);
+    size_t offset = tail & (SHM_RING_BYTES - 1);
+    size_t first = std::min(count, (size_t)SHM_RING_BYTES - offset);
+    memcpy(data, ring->data + offset, first);
+    memcpy(data + first, ring->data, count - first);
+    ring->tail.store(tail + count);
+    if(ring->tailWaiter.load() != 0) {
+        Wake(&ring->tail);
+    }
+    return count;
+}
+
+ShmStreamBuf::ShmStreamBuf(ShmChannel *channel) : m_channel(channel) {
+    setg(m_get, m_get, m_get);
+    setp(m_put, m_put + SHM_STREAM_BYTES);
+}
+
+ShmStreamBuf::int_type ShmStreamBuf::underflow(void) {
+    if(gptr() == egptr()) {
+        size_t count = m_channel->Read((uint8_t *)m_get, SHM_STREAM_BYTES);
+        if(count == 0) {
+            return traits_type::eof();
+        }
+        setg(m_get, m_get, m_get + count);
+    }
+    return traits_type::to_int_type(*gptr());
+}
+
+ShmStreamBuf::int_type ShmStreamBuf::overflow(int_type c) {
+    if(sync() == -1) {
+        return traits_type::eof();
+    }
+    if(!traits_type::eq_int_type(c, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+int ShmStreamBuf::sync(void) {
+    bool sent = m_channel->Write((const uint8_t *)pbase(), pptr() - pbase());
+    setp(m_put, m_put + SHM_STREAM_BYTES);
+    return sent ? 0 : -1;
+}
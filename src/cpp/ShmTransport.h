@@ -0,0 +1,113 @@
+/* DOMINION
+ * David Mally, Richard Roberts
+ * ShmTransport.h
+ * Declares a transport for agents on the same host: a shared-memory
+ * segment holding one single-producer/single-consumer byte ring each
+ * way, and a streambuf over it so the binary protocol runs on it as is.
+ */
+#ifndef __SHM_TRANSPORT_H__
+#define __SHM_TRANSPORT_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <streambuf>
+#include <string>
+#include <sys/types.h>
+
+// Bytes in each ring; a power of two, and several records' worth
+#define SHM_RING_BYTES 65536
+// Times a waiting side polls before it sleeps on a futex
+#define SHM_SPIN_LIMIT 4096
+// Longest futex sleep; on waking the waiter checks that its peer is
+// still alive, so a killed agent can't hang the engine
+#define SHM_WAIT_NS 10000000
+// Identifies a segment laid out as below ("DOM1")
+#define SHM_MAGIC 0x444F4D31
+// Bytes buffered on each side of a ShmStreamBuf
+#define SHM_STREAM_BYTES 4096
+
+static_assert((SHM_RING_BYTES & (SHM_RING_BYTES - 1)) == 0,
+              "SHM_RING_BYTES must be a power of two");
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "ring indices must be lock-free to be shared");
+
+// One direction. Both indices count bytes ever moved and wrap at 2^32;
+// head is written only by the producer, tail only by the consumer. Each
+// sits on its own cache line, next to the flag saying someone sleeps on
+// it.
+struct ShmRing {
+    alignas(64) std::atomic<uint32_t> head;
+    std::atomic<uint32_t> headWaiter;
+    alignas(64) std::atomic<uint32_t> tail;
+    std::atomic<uint32_t> tailWaiter;
+    alignas(64) uint8_t data[SHM_RING_BYTES];
+};
+
+struct ShmSegment {
+    // SHM_MAGIC once the engine has set everything else up
+    std::atomic<uint32_t> magic;
+    // Set by whichever side leaves first
+    std::atomic<uint32_t> closed;
+    std::atomic<pid_t> enginePid;
+    std::atomic<pid_t> agentPid;
+    ShmRing toAgent;
+    ShmRing toEngine;
+};
+
+// One side's mapping of a segment. The engine creates it and the agent
+// attaches to it by name; either side's reads and writes then go to the
+// right ring.
+class ShmChannel {
+    private:
+        std::string m_name;
+        bool m_engine;
+        ShmSegment *m_seg;
+        // Maps `name`, creating it (and becoming the engine) if asked
+        bool Map(const std::string &name, bool create);
+        // Whether the other side is still there to talk to
+        bool PeerAlive(void) const;
+        // Waits until `index` no longer holds `value`; false if the peer
+        // has gone
+        bool WaitWhile(const std::atomic<uint32_t> &index,
+                       std::atomic<uint32_t> *waiter, uint32_t value) const;
+    public:
+        ShmChannel(void);
+        ShmChannel(const ShmChannel &other) = delete;
+        ShmChannel &operator=(const ShmChannel &other) = delete;
+        // Closes the channel, and removes the segment's name if this is
+        // the engine
+        ~ShmChannel(void);
+        // Creates the segment `name` (e.g. "/dominion") for the engine.
+        // Returns false if it can't.
+        bool Create(const std::string &name);
+        // Attaches to the segment `name` for an agent. Returns false if
+        // there isn't one ready.
+        bool Attach(const std::string &name);
+        // Tells the other side nothing more is coming
+        void Close(void);
+        // Copies all of `data` into the outgoing ring, waiting for room.
+        // Returns false if the peer has gone.
+        bool Write(const uint8_t *data, size_t size);
+        // Waits for the incoming ring to hold anything and copies up to
+        // `size` bytes of it. Returns the bytes copied, 0 once the peer
+        // has gone and the ring is empty.
+        size_t Read(uint8_t *data, size_t size);
+};
+
+// Lets an std::istream and std::ostream share a channel, the same way a
+// BinaryDecider shares stdin and stdout
+class ShmStreamBuf : public std::streambuf {
+    private:
+        ShmChannel *m_channel;
+        char m_get[SHM_STREAM_BYTES];
+        char m_put[SHM_STREAM_BYTES];
+    protected:
+        int_type underflow(void);
+        int_type overflow(int_type c);
+        int sync(void);
+    public:
+        explicit ShmStreamBuf(ShmChannel *channel);
+};
+
+#endif
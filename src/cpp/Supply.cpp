@@ -0,0 +1,61 @@
+/* DOMINION
+ * David Mally, Richard Roberts
+ * Supply.cpp
+ * Defines Supply class, which holds every supply pile in a game and
+ * keeps track of how close the game is to ending as cards are taken.
+ */
+#include <vector>
+#include "Supply.h"
+#include "SupplyPile.h"
+#include "Pile.h"
+#include "CardLookup.h"
+
+Supply::Supply(std::vector<SupplyPile> piles) {
+    m_piles = piles;
+    m_numEmpty = 0;
+    m_provincesGone = false;
+    for(int card = 0; card < NUM_CARDS; card++) {
+        m_slots[card] = CARD_NOT_FOUND;
+    }
+    for(int cost = 0; cost <= MAX_SUPPLY_COST; cost++) {
+        m_buyable[cost] = 0;
+    }
+    for(size_t i = 0; i < m_piles.size(); i++) {
+        CardId card = m_piles[i].GetTopCard();
+        m_slots[card] = i;
+        for(int cost = lookup::GetCard(card).GetCost();
+            cost <= MAX_SUPPLY_COST; cost++) {
+            m_buyable[cost] |= CARD_BIT(card);
+        }
+        NoteTaken(i);
+    }
+}
+
+void Supply::NoteTaken(size_t idx) {
+    if(m_piles[idx].Size() == 0) {
+        CardId card = m_piles[idx].GetTopCard();
+        for(int cost = lookup::GetCard(card).GetCost();
+            cost <= MAX_SUPPLY_COST; cost++) {
+            m_buyable[cost] &= ~CARD_BIT(card);
+        }
+        m_numEmpty++;
+        if(card == CARD_PROVINCE) {
+            m_provincesGone = true;
+        }
+    }
+}
+
+CardId Supply::Draw(size_t idx) {
+    CardId card = m_piles.at(idx).DrawTopCard();
+    if(card != NO_CARD) {
+        NoteTaken(idx);
+    }
+    return card;
+}
+
+void Supply::Take(size_t idx, Pile *other) {
+    if(m_piles.at(idx).Size() > 0) {
+        m_piles[idx].Move(0, other);
+        NoteTaken(idx);
+    }
+}
@@ -0,0 +1,65 @@
+/* DOMINION
+ * David Mally, Richard Roberts
+ * Supply.h
+ * Defines Supply class, which holds every supply pile in a game and
+ * keeps track of how close the game is to ending as cards are taken.
+ */
+#ifndef __SUPPLY_H__
+#define __SUPPLY_H__
+
+#include <vector>
+#include "Card.h"
+#include "Pile.h"
+#include "SupplyPile.h"
+
+// Highest cost of any card; cost limits above it are capped to it
+#define MAX_SUPPLY_COST 8
+
+class Supply {
+    private:
+        std::vector<SupplyPile> m_piles;
+        int m_numEmpty;
+        bool m_provincesGone;
+        // Pile index holding each card kind, or CARD_NOT_FOUND
+        int m_slots[NUM_CARDS];
+        // m_buyable[n] holds every kind with cards left costing <= $n
+        CardMask m_buyable[MAX_SUPPLY_COST + 1];
+        // Updates the end-of-game tracking if pile `idx` has just run out
+        void NoteTaken(size_t idx);
+    public:
+        // Creates a supply made of `piles`, in that order
+        Supply(std::vector<SupplyPile> piles = std::vector<SupplyPile>());
+        // Returns the number of piles
+        size_t Size(void) const { return m_piles.size(); }
+        // Returns pile `idx`; piles can only lose cards through the supply
+        const SupplyPile &At(size_t idx) const { return m_piles.at(idx); }
+        std::vector<SupplyPile>::const_iterator begin(void) const {
+            return m_piles.begin();
+        }
+        std::vector<SupplyPile>::const_iterator end(void) const {
+            return m_piles.end();
+        }
+        // Returns the index of the pile holding `card`, or CARD_NOT_FOUND
+        int IndexOf(CardId card) const {
+            return card < NUM_CARDS ? m_slots[card] : CARD_NOT_FOUND;
+        }
+        // Returns every card kind that can still be gained for `cost`
+        CardMask BuyableAtMost(int cost) const {
+            if(cost < 0) { return 0; }
+            return m_buyable[cost < MAX_SUPPLY_COST ? cost : MAX_SUPPLY_COST];
+        }
+        // Returns true if a `card` is left and costs at most `cost`
+        bool CanGain(CardId card, int cost) const {
+            return card < NUM_CARDS && (BuyableAtMost(cost) & CARD_BIT(card));
+        }
+        // Returns & removes a card from pile `idx`, or NO_CARD if empty
+        CardId Draw(size_t idx);
+        // Puts a card from pile `idx` on top of `other`, if there is one
+        void Take(size_t idx, Pile *other);
+        // Returns how many piles have run out
+        int GetNumEmpty(void) const { return m_numEmpty; }
+        // Returns true once the province pile has run out
+        bool ProvincesGone(void) const { return m_provincesGone; }
+};
+
+#endif
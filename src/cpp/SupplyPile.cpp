@@ -0,0 +1,35 @@
+/* DOMINION
+ * David Mally, Richard Roberts
+ * SupplyPile.cpp
+ * Defines SupplyPile class, which represents a homogeneous pile of
+ * buyable cards in the kingdom as a card id and a remaining count.
+ */
+#include "SupplyPile.h"
+#include "Pile.h"
+#include "CardLookup.h"
+
+SupplyPile::SupplyPile(Owner owner, CardId card, int size) {
+    m_owner = owner;
+    m_card = card;
+    m_count = size;
+}
+
+const char *SupplyPile::GetName(void) const {
+    return lookup::GetCard(m_card).GetName();
+}
+
+CardId SupplyPile::DrawTopCard(void) {
+    if(m_count > DEF_SIZE) {
+        m_count--;
+        return m_card;
+    } else {
+        return NO_CARD;
+    }
+}
+
+void SupplyPile::Move(int, Pile *other) {
+    if(m_count > DEF_SIZE) {
+        m_count--;
+        other->TopDeck(m_card);
+    }
+}
@@ -0,0 +1,37 @@
+/* DOMINION
+ * David Mally, Richard Roberts
+ * SupplyPile.h
+ * Defines SupplyPile class, which represents a homogeneous pile of
+ * buyable cards in the kingdom as a card id and a remaining count.
+ */
+#ifndef __SUPPLYPILE_H__
+#define __SUPPLYPILE_H__
+
+#include "Card.h"
+#include "Pile.h"
+
+class SupplyPile {
+    private:
+        Owner m_owner;
+        CardId m_card;
+        int m_count;
+    public:
+        // Creates a supply pile holding `size` copies of `card`
+        SupplyPile(Owner owner = KINGDOM, CardId card = NO_CARD,
+                   int size = DEF_SIZE);
+        // Returns the number of cards left in the pile
+        size_t Size(void) const { return m_count; }
+        // Returns the pile's owner
+        Owner GetOwner(void) const { return m_owner; }
+        // Returns the name of the card this pile holds
+        const char *GetName(void) const;
+        // Returns the card this pile holds, even once it is empty
+        CardId GetTopCard(void) const { return m_card; }
+        // Returns & removes the top card on the pile, or NO_CARD if empty
+        CardId DrawTopCard(void);
+        // Puts one card from this pile into `other`; all cards in a
+        // supply pile are identical, so `idx` is ignored
+        void Move(int idx, Pile *other);
+};
+
+#endif
@@ -0,0 +1,54 @@
+/* DOMINION
+ * David Mally, Richard Roberts
+ * Task.cpp
+ * Defines the per-thread pool coroutine frames are recycled through.
+ */
+#include <cstddef>
+#include <new>
+
+#include "Task.h"
+
+namespace {
+    // One free list per size class, linked through the frames themselves
+    struct FramePool {
+        void *free[TASK_FRAME_CLASSES] = {};
+        ~FramePool(void) {
+            for(void *&list : free) {
+                while(list != NULL) {
+                    void *next = *(void **)list;
+                    ::operator delete(list);
+                    list = next;
+                }
+            }
+        }
+    };
+
+    thread_local FramePool pool;
+
+    size_t ClassOf(size_t size) {
+        return (size + TASK_FRAME_GRAIN - 1) / TASK_FRAME_GRAIN;
+    }
+}
+
+void *task_frames::Allocate(size_t size) {
+    size_t sizeClass = ClassOf(size);
+    if(sizeClass >= TASK_FRAME_CLASSES) {
+        return ::operator new(size);
+    }
+    void *frame = pool.free[sizeClass];
+    if(frame == NULL) {
+        return ::operator new(sizeClass * TASK_FRAME_GRAIN);
+    }
+    pool.free[sizeClass] = *(void **)frame;
+    return frame;
+}
+
+void task_frames::Free(void *frame, size_t size) {
+    size_t sizeClass = ClassOf(size);
+    if(sizeClass >= TASK_FRAME_CLASSES) {
+        ::operator delete(frame);
+        return;
+    }
+    *(void **)frame = pool.free[sizeClass];
+    pool.free[sizeClass] = frame;
+}
@@ -0,0 +1,117 @@
+/* DOMINION
+ * David Mally, Richard Roberts
+ * Task.h
+ * Defines Task, the coroutine type returned by the phases, the card
+ * effects and the decision wrappers, so a game can be suspended wherever
+ * a player has to answer and resumed once the answer has arrived.
+ */
+#ifndef __TASK_H__
+#define __TASK_H__
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+// Frames are recycled in size classes this many bytes apart
+#define TASK_FRAME_GRAIN 64
+// Size classes recycled; a bigger frame comes from the heap every time
+#define TASK_FRAME_CLASSES 32
+
+// Coroutine frames are kept for reuse by the thread that frees them, so
+// a game that has been running a while asks and answers without touching
+// the heap
+namespace task_frames {
+    void *Allocate(size_t size);
+    void Free(void *frame, size_t size);
+}
+
+// Where a Task's body leaves its result
+template <typename T>
+struct TaskResult {
+    T value{};
+    void return_value(T result) { value = std::move(result); }
+};
+
+template <>
+struct TaskResult<void> {
+    void return_void(void) {}
+};
+
+/* A Task starts running as soon as it is called, and keeps running until
+ * it ends or awaits a decision whose answer hasn't arrived (see
+ * DecisionProvider::Pending). A game whose players answer in place never
+ * waits, so calling a phase or effect runs it to the end like any other
+ * function, and Get() has the result. A game that does wait is left
+ * suspended with nothing on the stack: whoever delivers the answer
+ * resumes it, and when an awaited Task ends the one awaiting it carries
+ * on. */
+template <typename T = void>
+class Task {
+    public:
+        struct promise_type;
+        typedef std::coroutine_handle<promise_type> Handle;
+
+        // Resumes whoever awaited the task once it ends, or returns to
+        // whoever resumed it if nobody did
+        struct FinalAwaiter {
+            bool await_ready(void) noexcept { return false; }
+            std::coroutine_handle<> await_suspend(Handle done) noexcept {
+                std::coroutine_handle<> next = done.promise().continuation;
+                return next ? next : std::noop_coroutine();
+            }
+            void await_resume(void) noexcept {}
+        };
+
+        struct promise_type : TaskResult<T> {
+            std::coroutine_handle<> continuation;
+            Task get_return_object(void) {
+                return Task(Handle::from_promise(*this));
+            }
+            std::suspend_never initial_suspend(void) noexcept { return {}; }
+            FinalAwaiter final_suspend(void) noexcept { return {}; }
+            void unhandled_exception(void) { std::terminate(); }
+            static void *operator new(size_t size) {
+                return task_frames::Allocate(size);
+            }
+            static void operator delete(void *frame, size_t size) {
+                task_frames::Free(frame, size);
+            }
+        };
+
+    private:
+        Handle m_handle;
+        explicit Task(Handle handle) : m_handle(handle) {}
+
+    public:
+        Task(void) : m_handle() {}
+        Task(Task &&other) : m_handle(std::exchange(other.m_handle, {})) {}
+        Task &operator=(Task &&other) {
+            std::swap(m_handle, other.m_handle);
+            return *this;
+        }
+        Task(const Task &other) = delete;
+        Task &operator=(const Task &other) = delete;
+        // Destroying a suspended task destroys every frame it awaits
+        ~Task(void) {
+            if(m_handle) {
+                m_handle.destroy();
+            }
+        }
+        // Whether the body has run to the end
+        bool Done(void) const { return !m_handle || m_handle.done(); }
+        // Returns the result of a task that is Done()
+        T Get(void) const {
+            if constexpr(!std::is_void_v<T>) {
+                return m_handle.promise().value;
+            }
+        }
+        bool await_ready(void) const { return Done(); }
+        void await_suspend(std::coroutine_handle<> awaiting) {
+            m_handle.promise().continuation = awaiting;
+        }
+        T await_resume(void) const { return Get(); }
+};
+
+#endif
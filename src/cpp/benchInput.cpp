@@ -0,0 +1,102 @@
+/* DOMINION
+ * David Mally, Richard Roberts
+ * benchInput.cpp
+ * Measures how many answers per second come through a pipe on stdin:
+ * with iostream extraction (the old read path), with InputReader, and
+ * as whole StdinDecider decisions on InputReader.
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+#include "CardLookup.h"
+#include "Decision.h"
+#include "GameArena.h"
+#include "GameState.h"
+#include "InputReader.h"
+
+// Answers fed through each pipe
+#define BENCH_ANSWERS 2000000
+
+namespace {
+    // Returns the read end of a pipe a thread fills with `count` copies
+    // of `answer`
+    int FeedPipe(const std::string &answer, int count, std::thread *writer) {
+        int fds[2];
+        if(pipe(fds) == -1) {
+            perror("pipe");
+            exit(EXIT_FAILURE);
+        }
+        *writer = std::thread([=]() {
+            std::string chunk;
+            for(int i = 0; i < 1024; i++) {
+                chunk += answer;
+            }
+            for(int sent = 0; sent < count; sent += 1024) {
+                if(write(fds[1], chunk.data(), chunk.size()) == -1) {
+                    break;
+                }
+            }
+            close(fds[1]);
+        });
+        return fds[0];
+    }
+
+    void Report(const char *name, int answers,
+                std::chrono::steady_clock::time_point start) {
+        std::chrono::duration<double> secs =
+            std::chrono::steady_clock::now() - start;
+        printf("%-32s %12.0f answers/sec\n", name, answers / secs.count());
+    }
+}
+
+int main(void) {
+    std::thread writer;
+
+    // Before: what every prompt used to do, std::cin >> int on stdin
+    int fd = FeedPipe("3\n", BENCH_ANSWERS, &writer);
+    dup2(fd, STDIN_FILENO);
+    close(fd);
+    auto start = std::chrono::steady_clock::now();
+    int choice;
+    long total = 0;
+    for(int i = 0; i < BENCH_ANSWERS && std::cin >> choice; i++) {
+        total += choice;
+    }
+    Report("iostream extraction", BENCH_ANSWERS, start);
+    writer.join();
+
+    // After: the same answers through InputReader
+    fd = FeedPipe("3\n", BENCH_ANSWERS, &writer);
+    InputReader reader(fd);
+    start = std::chrono::steady_clock::now();
+    long value;
+    for(int i = 0; i < BENCH_ANSWERS &&
+        InputReader::ParseInt(reader.NextToken(), &value); i++) {
+        total += value;
+    }
+    Report("InputReader", BENCH_ANSWERS, start);
+    writer.join();
+    close(fd);
+
+    // Whole yes/no decisions, prompts and checks included
+    GameArena arena;
+    game_state::SetOutput(NULL);
+    fd = FeedPipe("y\n", BENCH_ANSWERS, &writer);
+    InputReader answers(fd);
+    decision::SetInput(&answers);
+    start = std::chrono::steady_clock::now();
+    for(int i = 0; i < BENCH_ANSWERS; i++) {
+        total += decision::YesNo(*arena.GetState(), true, DEC_CHANCELLOR,
+                                 NO_CARD).Get();
+    }
+    Report("StdinDecider decisions", BENCH_ANSWERS, start);
+    decision::SetInput(NULL);
+    writer.join();
+    close(fd);
+    return total == 0;
+}
@@ -3,41 +3,157 @@
  * main.cpp
  * Contains main function that runs the main game loop.
  */
+#include <cstdint>
 #include <cstdlib>
+#include <ctime>
 #include <iostream>
 #include <string>
 #include <vector>
 #include <ncurses.h>
 
 #include "Card.h"
-#include "ActionCard.h"
 #include "Defs.h"
-#include "ActionCard.h"
 #include "Pile.h"
+#include "SupplyPile.h"
+#include "Supply.h"
 #include "RandUtils.h"
 #include "CardLookup.h"
 #include "Player.h"
 #include "GameState.h"
+#include "GameArena.h"
+#include "Protocol.h"
+#include "ShmTransport.h"
+#include "GameServer.h"
 
-#define P1_NUM 1
-#define P2_NUM 2
+// Drops all human-facing text; only the GSV protocol and results remain
+#define HEADLESS_FLAG "--headless"
+// Both players speak the binary protocol (see Protocol.h) over
+// stdin/stdout; implies headless
+#define BINARY_FLAG "--binary"
+// Followed by a segment name: both players speak the binary protocol
+// through shared memory (see ShmTransport.h); implies headless
+#define SHM_FLAG "--shm"
+// Followed by a socket path: hosts any number of games for agents that
+// connect there (see GameServer.h) instead of playing one here
+#define SERVE_FLAG "--serve"
+// Questions with only one legal outcome are answered without asking
+#define AUTO_FLAG "--auto"
+// Every treasure in hand is played at once, without asking
+#define AUTO_TREASURES_FLAG "--auto-treasures"
+// GSVs after the first of each turn carry only what changed (see GsvLog)
+#define DELTA_FLAG "--delta"
+// GSVs are sent only in answer to STATE_CMD; implies headless, so a
+// prompt is just "response?"
+#define LAZY_FLAG "--lazy"
+// Followed by milliseconds: the longest each answer may take
+#define MOVE_MS_FLAG "--move-ms"
+// Followed by milliseconds: the longest all of a player's answers in the
+// game may take together
+#define GAME_MS_FLAG "--game-ms"
+// Followed by "pass", "first" or "heuristic": what answers for a player
+// who runs out of time (see Fallback); heuristic by default
+#define FALLBACK_FLAG "--fallback"
 
-int main(void) {
-    Pile trash(TRASH);
-    // Initialize kingdom piles (buyable cards)
-    std::vector<Pile> kingdomCards = game_state::GenerateKingdom(
-                                                 lookup::GenAllCards());
-    // Initialize players
-    Player p1 = Player(P1_NUM, "p1");
-    Player p2 = Player(P2_NUM, "p2");
-    Player *currPlayer = &p1;
+// Reports how often each player ran out of time, if they were timed
+void PrintTimeouts(const struct stateBlock &state, std::ostream &out) {
+    if(!state.p1Clock->IsSet()) {
+        return;
+    }
+    out << "Timeouts:\n\tPlayer 1: " << state.p1Clock->GetTimeouts()
+        << "\n\tPlayer 2: " << state.p2Clock->GetTimeouts() << std::endl;
+}
 
-    // Initialize game state shared object
-    struct stateBlock state;
-    state.p1        = &p1;
-    state.p2        = &p2;
-    state.trash     = &trash;
-    state.kingdom   = &kingdomCards;
+int main(int argc, char *argv[]) {
+    bool binary = false;
+    const char *shmName = NULL;
+    const char *servePath = NULL;
+    bool delta = false;
+    bool lazy = false;
+    bool autoResolve = false;
+    bool autoTreasures = false;
+    int64_t moveMs = 0;
+    int64_t gameMs = 0;
+    Fallback fallback = FALLBACK_HEURISTIC;
+    for(int i = 1; i < argc; i++) {
+        if(std::string(argv[i]) == HEADLESS_FLAG) {
+            game_state::SetOutput(NULL);
+        } else if(std::string(argv[i]) == BINARY_FLAG) {
+            game_state::SetOutput(NULL);
+            binary = true;
+        } else if(std::string(argv[i]) == SHM_FLAG && i + 1 < argc) {
+            game_state::SetOutput(NULL);
+            shmName = argv[++i];
+        } else if(std::string(argv[i]) == SERVE_FLAG && i + 1 < argc) {
+            servePath = argv[++i];
+        } else if(std::string(argv[i]) == DELTA_FLAG) {
+            delta = true;
+        } else if(std::string(argv[i]) == AUTO_FLAG) {
+            autoResolve = true;
+        } else if(std::string(argv[i]) == AUTO_TREASURES_FLAG) {
+            autoTreasures = true;
+        } else if(std::string(argv[i]) == LAZY_FLAG) {
+            game_state::SetOutput(NULL);
+            lazy = true;
+        } else if(std::string(argv[i]) == MOVE_MS_FLAG && i + 1 < argc) {
+            moveMs = atoll(argv[++i]);
+        } else if(std::string(argv[i]) == GAME_MS_FLAG && i + 1 < argc) {
+            gameMs = atoll(argv[++i]);
+        } else if(std::string(argv[i]) == FALLBACK_FLAG && i + 1 < argc) {
+            if(!decision::ParseFallback(argv[++i], &fallback)) {
+                std::cerr << "Unknown fallback " << argv[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    if(servePath != NULL) {
+        // Every hosted game is played under the flags given
+        GameOptions options;
+        options.delta = delta;
+        options.autoResolve = autoResolve;
+        options.autoTreasures = autoTreasures;
+        options.moveMs = moveMs;
+        options.gameMs = gameMs;
+        options.fallback = fallback;
+        GameServer server(time(NULL), options);
+        if(!server.Listen(servePath)) {
+            std::cerr << "Can't listen on " << servePath << std::endl;
+            return EXIT_FAILURE;
+        }
+        server.Run();
+        return 0;
+    }
+    // Initialize players, trash and kingdom piles (buyable cards)
+    GameArena arena(time(NULL));
+    struct stateBlock &state = *arena.GetState();
+    arena.SetDeltaGsv(delta);
+    arena.SetLazyGsv(lazy);
+    arena.SetAutoResolve(autoResolve);
+    arena.SetAutoTreasures(autoTreasures);
+    arena.SetTimeControl(moveMs, gameMs, fallback);
+    BinaryDecider binaryDecider(&std::cin, &std::cout);
+    ShmChannel channel;
+    ShmStreamBuf shmBuf(&channel);
+    std::istream shmIn(&shmBuf);
+    std::ostream shmOut(&shmBuf);
+    BinaryDecider shmDecider(&shmIn, &shmOut);
+    BinaryDecider *decider = NULL;
+    if(shmName != NULL) {
+        if(!channel.Create(shmName)) {
+            std::cerr << "Can't create shared memory " << shmName
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+        decider = &shmDecider;
+    } else if(binary) {
+        decider = &binaryDecider;
+    }
+    if(decider != NULL) {
+        arena.SetDeciders(decider, decider);
+    }
+    Player &p1 = *state.p1;
+    Player &p2 = *state.p2;
+    Supply &kingdomCards = *state.kingdom;
+    Player *currPlayer = &p1;
 
     // system(CLEAR);
     // int gameMode = game_state::SplashScreen();
@@ -65,14 +181,15 @@ int main(void) {
         if(p1Turn) { currPlayer = &p2; }
         else { currPlayer = &p1; }
     }
-    // Consolidate all cards into decks
-    p1.DeckPtr()->TakeAllFrom(p1.HandPtr());
-    p1.DeckPtr()->TakeAllFrom(p1.DiscardPtr());
-    p2.DeckPtr()->TakeAllFrom(p2.HandPtr());
-    p2.DeckPtr()->TakeAllFrom(p2.DiscardPtr());
-    // Score decks
-    int scoreP1 = game_state::ScoreDeck(p1.GetDeck());
-    int scoreP2 = game_state::ScoreDeck(p2.GetDeck());
+    // The binary record has no field for timeouts, so they go to stderr
+    if(decider != NULL) {
+        PrintTimeouts(state, std::cerr);
+        decider->GameOver(state);
+        return 0;
+    }
+    // Score every card each player owns
+    int scoreP1 = p1.GetScore();
+    int scoreP2 = p2.GetScore();
     if(scoreP1 > scoreP2) {
         std::cout << "Player 1 wins!" << std::endl;
     } else {
@@ -81,5 +198,6 @@ int main(void) {
     std::cout << "Scores:\n\tPlayer 1: " << std::to_string(scoreP1)
               << "\n\tPlayer 2: " << std::to_string(scoreP2)
               << std::endl;
+    PrintTimeouts(state, std::cout);
     return 0;
 }
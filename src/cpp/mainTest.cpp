@@ -3,20 +3,68 @@
  * mainTest.cpp
  * Contains all unit tests.
  */
-#include "ActionCard.h"
 #include "Card.h"
 #include "CardLookup.h"
 #include "Defs.h"
 #include "GameState.h"
 #include "Pile.h"
+#include "SupplyPile.h"
+#include "Supply.h"
 #include "Player.h"
 #include "RandUtils.h"
-#include "TreasureCard.h"
-#include "VictoryCard.h"
+#include "GameArena.h"
+#include "Decision.h"
+#include "Protocol.h"
+#include "ShmTransport.h"
+#include "GameServer.h"
+#include "InputReader.h"
 
 #include "gtest/gtest.h"
 
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdlib>
 #include <iostream>
+#include <new>
+#include <sstream>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define NUM_ARENA_GAMES 2000
+#define NUM_WARMUP_GAMES 10
+#define MAX_ARENA_TURNS 1000
+#define NUM_CAMPAIGN_GAMES 256
+#define NUM_CAMPAIGN_THREADS 8
+#define NUM_SUSPENDED_GAMES 100
+#define NUM_BOT_SEEDS 500
+
+// Count heap traffic so tests can check hot paths are allocation-free
+static std::atomic<size_t> numAllocs(0);
+static std::atomic<size_t> numFrees(0);
+
+void *operator new(size_t size) {
+    numAllocs++;
+    void *ptr = malloc(size ? size : 1);
+    if(ptr == NULL) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+    if(ptr != NULL) {
+        numFrees++;
+        free(ptr);
+    }
+}
+
+void operator delete(void *ptr, size_t size) noexcept {
+    (void)size;
+    operator delete(ptr);
+}
 
 using namespace std;
 using ::testing::EmptyTestEventListener;
@@ -30,150 +78,478 @@ using ::testing::UnitTest;
 
 namespace {
 
-vector<Card> randCards;
+vector<CardId> randCards;
+
+// Plays one silent big-money turn: play every treasure, buy the best of
+// province/gold/silver, then clean up.
+void PlayBigMoneyTurn(Player *player, Supply *kingdom) {
+    const Pile &hand = player->GetHand();
+    for(size_t i = hand.Size(); i-- > 0;) {
+        const Card &card = lookup::GetCard(hand.At(i));
+        if(card.GetType() == TREASURE_C) {
+            player->AddCoins(card.GetCoins());
+            player->DiscardCard(i);
+        }
+    }
+    CardId buy = NO_CARD;
+    if(player->GetCoins() >= 8) {
+        buy = CARD_PROVINCE;
+    } else if(player->GetCoins() >= 6) {
+        buy = CARD_GOLD;
+    } else if(player->GetCoins() >= 3) {
+        buy = CARD_SILVER;
+    }
+    for(size_t i = 0; i < kingdom->Size(); i++) {
+        if(kingdom->At(i).GetTopCard() == buy) {
+            kingdom->Take(i, player->DiscardPtr());
+        }
+    }
+    player->DiscardPtr()->TakeAllFrom(player->HandPtr());
+    player->SetNewTurn();
+}
+
+// Plays game `game` of campaign `seed` with big money and returns a
+// fingerprint of how it ended
+uint64_t PlayCampaignGame(GameArena *arena, uint64_t seed, uint64_t game) {
+    arena->Seed(seed, game);
+    arena->Reset();
+    struct stateBlock *state = arena->GetState();
+    bool p1Turn = true;
+    int turn = 0;
+    for(; turn < MAX_ARENA_TURNS &&
+        !game_state::GameOver(*state->kingdom); turn++) {
+        PlayBigMoneyTurn(p1Turn ? state->p1 : state->p2, state->kingdom);
+        p1Turn = !p1Turn;
+    }
+    uint64_t hash = turn;
+    for(const Pile *pile : {&state->p1->GetDeck(), &state->p2->GetDeck(),
+                            &state->p1->GetHand(), &state->p2->GetHand()}) {
+        for(CardId card : pile->GetCards()) {
+            hash = hash * 31 + card;
+        }
+    }
+    for(const SupplyPile &pile : *state->kingdom) {
+        hash = hash * 31 + pile.GetTopCard();
+    }
+    return hash;
+}
+
+// Trashes every estate with chapel and otherwise plays like BotDecider
+class ChapelBot : public BotDecider {
+    public:
+        void ChooseManyFromHand(const struct stateBlock &state, bool p1,
+                                Decision type, const Pile &hand,
+                                CardMask options, int min, int max,
+                                std::vector<int> *picks) {
+            if(type != DEC_CHAPEL) {
+                BotDecider::ChooseManyFromHand(state, p1, type, hand,
+                                               options, min, max, picks);
+                return;
+            }
+            for(size_t i = 0; i < hand.Size(); i++) {
+                if(hand.At(i) == CARD_ESTATE) {
+                    picks->push_back(i);
+                }
+            }
+        }
+};
+
+// Discards its whole hand to cellar
+class CellarBot : public BotDecider {
+    public:
+        void ChooseManyFromHand(const struct stateBlock &, bool, Decision,
+                                const Pile &hand, CardMask, int, int,
+                                std::vector<int> *picks) {
+            for(size_t i = 0; i < hand.Size(); i++) {
+                picks->push_back(i);
+            }
+        }
+};
+
+// Counts the questions it is asked, by Decision
+class CountingBot : public BotDecider {
+    public:
+        int asked[NUM_DECISIONS] = {};
+        int ChooseFromHand(const struct stateBlock &state, bool p1,
+                           Decision type, const Pile &hand,
+                           CardMask options, bool canDecline) {
+            asked[type]++;
+            return BotDecider::ChooseFromHand(state, p1, type, hand,
+                                              options, canDecline);
+        }
+        void ChooseManyFromHand(const struct stateBlock &state, bool p1,
+                                Decision type, const Pile &hand,
+                                CardMask options, int min, int max,
+                                std::vector<int> *picks) {
+            asked[type]++;
+            BotDecider::ChooseManyFromHand(state, p1, type, hand, options,
+                                           min, max, picks);
+        }
+        int ChooseFromSupply(const struct stateBlock &state, bool p1,
+                             Decision type, CardMask options,
+                             int maxCost, bool canDecline) {
+            asked[type]++;
+            return BotDecider::ChooseFromSupply(state, p1, type, options,
+                                                maxCost, canDecline);
+        }
+        bool ChooseYesNo(const struct stateBlock &state, bool p1,
+                         Decision type, CardId card) {
+            asked[type]++;
+            return BotDecider::ChooseYesNo(state, p1, type, card);
+        }
+        int Total(void) const {
+            int total = 0;
+            for(int count : asked) {
+                total += count;
+            }
+            return total;
+        }
+};
+
+// Answers every question with nonsense
+class LiarBot : public BotDecider {
+    public:
+        int ChooseFromHand(const struct stateBlock &, bool, Decision,
+                           const Pile &, CardMask, bool) {
+            return 99;
+        }
+        void ChooseManyFromHand(const struct stateBlock &, bool, Decision,
+                                const Pile &, CardMask, int, int,
+                                std::vector<int> *picks) {
+            picks->push_back(99);
+            picks->push_back(0);
+            picks->push_back(0);
+        }
+        int ChooseFromSupply(const struct stateBlock &, bool, Decision,
+                             CardMask, int, bool) {
+            return -7;
+        }
+};
+
+// Plays one game of `cardSet` between two BotDeciders through the real
+// phase functions, headless, and returns its turn count
+int PlayBotGame(GameArena *arena, uint64_t seed,
+                const vector<CardId> &cardSet,
+                DecisionProvider *p1 = NULL, DecisionProvider *p2 = NULL) {
+    BotDecider bot1;
+    BotDecider bot2;
+    arena->Seed(seed);
+    arena->Reset(cardSet);
+    arena->SetDeciders(p1 != NULL ? p1 : &bot1, p2 != NULL ? p2 : &bot2);
+    struct stateBlock *state = arena->GetState();
+    game_state::SetOutput(NULL);
+    bool p1Turn = true;
+    int turn = 0;
+    for(; turn < MAX_ARENA_TURNS &&
+        !game_state::GameOver(*state->kingdom); turn++) {
+        game_state::ActionPhase(state, p1Turn);
+        game_state::TreasurePhase(state, p1Turn);
+        game_state::BuyPhase(state, p1Turn);
+        game_state::CleanupPhase(state, p1Turn);
+        p1Turn = !p1Turn;
+    }
+    game_state::SetOutput(&std::cout);
+    arena->SetDeciders(NULL, NULL);
+    return turn;
+}
 
 TEST(PileTest, Constructor1) {
     Pile p1 = Pile(KINGDOM);
-    EXPECT_EQ(0, p1.getCards().size());
-    EXPECT_EQ(KINGDOM, p1.getOwner());
+    EXPECT_EQ(0, p1.GetCards().size());
+    EXPECT_EQ(KINGDOM, p1.GetOwner());
 }
 
 TEST(PileTest, Constructor2) {
-    Pile p2 = Pile(KINGDOM, (Card)lookup::village, 10);
-    EXPECT_EQ(10, p2.getCards().size());
-    EXPECT_EQ(KINGDOM, p2.getOwner());
+    Pile p2 = Pile(KINGDOM, CARD_VILLAGE, 10);
+    EXPECT_EQ(10, p2.GetCards().size());
+    EXPECT_EQ(KINGDOM, p2.GetOwner());
 }
 
 TEST(PileTest, EmptyDeck) {
-    Pile p2 = Pile(KINGDOM, (Card)lookup::village, 10);
-    p2.emptyDeck();
-    EXPECT_EQ(0, p2.getCards().size());
+    Pile p2 = Pile(KINGDOM, CARD_VILLAGE, 10);
+    p2.EmptyDeck();
+    EXPECT_EQ(0, p2.GetCards().size());
 }
 
-TEST(PileTest, getTopCard) {
-    Pile p2 = Pile(KINGDOM, lookup::village, 10);
-    Card *card = p2.getTopCard();
-    EXPECT_EQ(10, p2.getCards().size());
-    EXPECT_EQ("village", card->GetName());
+TEST(PileTest, GetTopCard) {
+    Pile p2 = Pile(KINGDOM, CARD_VILLAGE, 10);
+    CardId card = p2.GetTopCard();
+    EXPECT_EQ(10, p2.GetCards().size());
+    EXPECT_EQ(CARD_VILLAGE, card);
 }
 
-TEST(PileTest, topDeck) {
-    Pile p2 = Pile(KINGDOM, (Card)lookup::village, 10);
-    p2.topDeck(new ActionCard(lookup::market));
-    EXPECT_EQ(11, p2.getCards().size());
-    EXPECT_EQ("market", p2.getTopCard()->GetName());
+TEST(PileTest, TopDeck) {
+    Pile p2 = Pile(KINGDOM, CARD_VILLAGE, 10);
+    p2.TopDeck(CARD_MARKET);
+    EXPECT_EQ(11, p2.GetCards().size());
+    EXPECT_EQ(CARD_MARKET, p2.GetTopCard());
 }
 
-TEST(PileTest, lookThrough) {
-    Pile p2 = Pile(KINGDOM, (Card)lookup::village, 10);
-    p2.topDeck(new ActionCard(lookup::market));
-    p2.printPileAsHand();
-    int idx = p2.lookThrough(new ActionCard(lookup::village));
+TEST(PileTest, LookThrough) {
+    Pile p2 = Pile(KINGDOM, CARD_VILLAGE, 10);
+    p2.TopDeck(CARD_MARKET);
+    p2.PrintPileAsHand();
+    int idx = p2.LookThrough(CARD_VILLAGE);
     EXPECT_EQ(0, idx);
-    idx = p2.lookThrough(new VictoryCard(lookup::gardens));
+    idx = p2.LookThrough(CARD_GARDENS);
     EXPECT_EQ(-1, idx);
 }
 
-// This test can nondeterministically fail due to RNJesus
-TEST(PileTest, trueShuffle) {
-    Pile p2 = Pile(KINGDOM, (Card)lookup::village, 1);
-    p2.topDeck(new ActionCard(lookup::market));
-    p2.topDeck(new VictoryCard(lookup::gardens));
-    p2.topDeck(new ActionCard(lookup::workshop));
-    p2.topDeck(new ActionCard(lookup::witch));
-    p2.topDeck(new ActionCard(lookup::smithy));
-    p2.topDeck(new ActionCard(lookup::councilroom));
-    p2.topDeck(new ActionCard(lookup::adventurer));
-    p2.topDeck(new ActionCard(lookup::woodcutter));
-    p2.topDeck(new ActionCard(lookup::throneroom));
-    p2.trueShuffle();
-    EXPECT_NE(p2.getTopCard()->GetName(), "market");
+// Seeded, so this fails deterministically if it fails at all
+TEST(PileTest, TrueShuffle) {
+    rand_utils::Rng rng(DEF_SEED);
+    Pile p2 = Pile(KINGDOM, CARD_VILLAGE, 1);
+    p2.TopDeck(CARD_MARKET);
+    p2.TopDeck(CARD_GARDENS);
+    p2.TopDeck(CARD_WORKSHOP);
+    p2.TopDeck(CARD_WITCH);
+    p2.TopDeck(CARD_SMITHY);
+    p2.TopDeck(CARD_COUNCILROOM);
+    p2.TopDeck(CARD_ADVENTURER);
+    p2.TopDeck(CARD_WOODCUTTER);
+    p2.TopDeck(CARD_THRONEROOM);
+    p2.TrueShuffle(&rng);
+    EXPECT_NE(p2.GetTopCard(), CARD_MARKET);
+}
+
+TEST(PileTest, TrueShuffleUniform) {
+    rand_utils::Rng rng(DEF_SEED);
+    int counts[3][3] = {};
+    for(int i = 0; i < 30000; i++) {
+        Pile p = Pile(PLAYER1);
+        p.TopDeck(CARD_COPPER);
+        p.TopDeck(CARD_SILVER);
+        p.TopDeck(CARD_GOLD);
+        p.TrueShuffle(&rng);
+        for(int pos = 0; pos < 3; pos++) {
+            counts[pos][p.At(pos) - CARD_COPPER]++;
+        }
+    }
+    // Every card lands in every position about a third of the time
+    for(int pos = 0; pos < 3; pos++) {
+        for(int card = 0; card < 3; card++) {
+            EXPECT_NEAR(counts[pos][card], 10000, 500);
+        }
+    }
+}
+
+TEST(PileTest, LazyShuffleUniform) {
+    rand_utils::Rng rng(DEF_SEED);
+    int counts[3][3] = {};
+    for(int i = 0; i < 30000; i++) {
+        Pile p = Pile(PLAYER1);
+        p.TopDeck(CARD_COPPER);
+        p.TopDeck(CARD_SILVER);
+        p.TopDeck(CARD_GOLD);
+        p.LazyShuffle(&rng);
+        // A card put on top afterwards is drawn first, untouched
+        p.TopDeck(CARD_CURSE);
+        EXPECT_EQ(p.DrawTopCard(), CARD_CURSE);
+        for(int draw = 0; draw < 3; draw++) {
+            counts[draw][p.DrawTopCard() - CARD_COPPER]++;
+        }
+        EXPECT_EQ(p.Size(), 0);
+    }
+    // Same odds as TrueShuffle, in the order the cards come off the top
+    for(int draw = 0; draw < 3; draw++) {
+        for(int card = 0; card < 3; card++) {
+            EXPECT_NEAR(counts[draw][card], 10000, 500);
+        }
+    }
 }
 
-TEST(PileTest, takeAllFrom) {
-    Pile p2 = Pile(KINGDOM, (Card)lookup::village, 10);
-    Pile p3 = Pile(KINGDOM, (Card)lookup::market, 10);
-    p2.takeAllFrom(&p3);
-    EXPECT_EQ(p2.getCards().size(), 20);
-    EXPECT_EQ(p3.getCards().size(), 0);
-    EXPECT_EQ(p2.getTopCard()->GetName(), "market");
+TEST(Player, lazyShuffleDraws) {
+    rand_utils::Rng rng(DEF_SEED);
+    Player p = Player(1, "p1", &rng);
+    p.SetLazyShuffle(true);
+    // Leave one known card on the deck and ten under it to reshuffle
+    p.HandPtr()->EmptyDeck();
+    p.DeckPtr()->EmptyDeck();
+    p.AddToDeck(CARD_GOLD);
+    for(int i = 0; i < 10; i++) {
+        p.AddToDiscard(CARD_SILVER);
+    }
+    p.DrawN(3);
+    EXPECT_EQ(p.GetHand().At(0), CARD_GOLD);
+    EXPECT_EQ(p.GetHand().Size(), 3);
+    EXPECT_EQ(p.GetDeck().Size(), 8);
+    EXPECT_EQ(p.GetDiscard().Size(), 0);
+}
+
+TEST(PileTest, counts) {
+    Pile p1 = Pile(KINGDOM, CARD_VILLAGE, 10);
+    Pile p2 = Pile(KINGDOM);
+    EXPECT_EQ(p1.Count(CARD_VILLAGE), 10);
+    EXPECT_FALSE(p1.Contains(CARD_MOAT));
+    p1.TopDeck(CARD_MOAT);
+    EXPECT_TRUE(p1.Contains(CARD_MOAT));
+    p1.MoveTop(3, &p2);
+    EXPECT_EQ(p1.Count(CARD_VILLAGE), 8);
+    EXPECT_EQ(p2.Count(CARD_MOAT), 1);
+    EXPECT_EQ(p2.Count(CARD_VILLAGE), 2);
+    p2.MoveCard(CARD_MOAT, &p1);
+    p1.Move(0, &p2);
+    p1.DrawAt(0);
+    p1.DrawTopCard();
+    EXPECT_EQ(p1.Count(CARD_MOAT), 0);
+    EXPECT_EQ(p1.Count(CARD_VILLAGE), 6);
+    p2.TakeAllUnder(&p1);
+    EXPECT_EQ(p2.Count(CARD_VILLAGE), 9);
+    EXPECT_EQ(p1.Count(CARD_VILLAGE), 0);
+    p1.TakeAllFrom(&p2);
+    EXPECT_EQ(p1.Count(CARD_VILLAGE), 9);
+    EXPECT_EQ(p1.Count(NO_CARD), 0);
+    p1.EmptyDeck();
+    EXPECT_FALSE(p1.Contains(CARD_VILLAGE));
+}
+
+TEST(PileTest, TakeAllFrom) {
+    Pile p2 = Pile(KINGDOM, CARD_VILLAGE, 10);
+    Pile p3 = Pile(KINGDOM, CARD_MARKET, 10);
+    p2.TakeAllFrom(&p3);
+    EXPECT_EQ(p2.GetCards().size(), 20);
+    EXPECT_EQ(p3.GetCards().size(), 0);
+    EXPECT_EQ(p2.GetTopCard(), CARD_MARKET);
 }
 
 TEST(PileTest, moveCard) {
-    Pile p2 = Pile(KINGDOM, (Card)lookup::village, 10);
+    Pile p2 = Pile(KINGDOM, CARD_VILLAGE, 10);
     Pile p3 = Pile(KINGDOM);
-    p2.move(new Card(lookup::village), &p3);
-    EXPECT_EQ(p2.getCards().size(), 9);
-    EXPECT_EQ(p3.getCards().size(), 1);
+    p2.MoveCard(CARD_VILLAGE, &p3);
+    EXPECT_EQ(p2.GetCards().size(), 9);
+    EXPECT_EQ(p3.GetCards().size(), 1);
 }
 
 TEST(PileTest, moveIndex) {
-    Pile p2 = Pile(KINGDOM, (Card)lookup::village, 10);
+    Pile p2 = Pile(KINGDOM, CARD_VILLAGE, 10);
     Pile p3 = Pile(KINGDOM);
-    p2.move(5, &p3);
-    EXPECT_EQ(p2.getCards().size(), 9);
-    EXPECT_EQ(p3.getCards().size(), 1);
+    p2.Move(5, &p3);
+    EXPECT_EQ(p2.GetCards().size(), 9);
+    EXPECT_EQ(p3.GetCards().size(), 1);
+}
+
+TEST(SupplyPileTest, moveAndDraw) {
+    SupplyPile copper = SupplyPile(TREASURE, CARD_COPPER, 2);
+    Pile discard = Pile(PLAYER1);
+    EXPECT_EQ(copper.Size(), 2);
+    copper.Move(0, &discard);
+    EXPECT_EQ(copper.Size(), 1);
+    EXPECT_EQ(discard.GetTopCard(), CARD_COPPER);
+    EXPECT_EQ(copper.DrawTopCard(), CARD_COPPER);
+    EXPECT_EQ(copper.Size(), 0);
+    // Empty piles still report their card but hand out nothing
+    EXPECT_EQ(copper.GetTopCard(), CARD_COPPER);
+    EXPECT_EQ(copper.DrawTopCard(), NO_CARD);
+    copper.Move(0, &discard);
+    EXPECT_EQ(discard.Size(), 1);
 }
 
 TEST(GameState, randomizeKingdom) {
-    vector<Card> kingdomCards;
-    kingdomCards.push_back(lookup::cellar);
-    kingdomCards.push_back(lookup::chapel);
-    kingdomCards.push_back(lookup::moat);
-    kingdomCards.push_back(lookup::chancellor);
-    kingdomCards.push_back(lookup::village);
-    kingdomCards.push_back(lookup::woodcutter);
-    kingdomCards.push_back(lookup::workshop);
-    kingdomCards.push_back(lookup::bureaucrat);
-    kingdomCards.push_back(lookup::feast);
-    kingdomCards.push_back(lookup::gardens);
-    kingdomCards.push_back(lookup::militia);
-    kingdomCards.push_back(lookup::moneylender);
-    kingdomCards.push_back(lookup::remodel);
-    kingdomCards.push_back(lookup::smithy);
-    kingdomCards.push_back(lookup::spy);
-    kingdomCards.push_back(lookup::thief);
-    kingdomCards.push_back(lookup::throneroom);
-    kingdomCards.push_back(lookup::councilroom);
-    kingdomCards.push_back(lookup::festival);
-    kingdomCards.push_back(lookup::laboratory);
-    kingdomCards.push_back(lookup::library);
-    kingdomCards.push_back(lookup::market);
-    kingdomCards.push_back(lookup::mine);
-    kingdomCards.push_back(lookup::witch);
-    kingdomCards.push_back(lookup::adventurer);
+    vector<CardId> kingdomCards;
+    kingdomCards.push_back(CARD_CELLAR);
+    kingdomCards.push_back(CARD_CHAPEL);
+    kingdomCards.push_back(CARD_MOAT);
+    kingdomCards.push_back(CARD_CHANCELLOR);
+    kingdomCards.push_back(CARD_VILLAGE);
+    kingdomCards.push_back(CARD_WOODCUTTER);
+    kingdomCards.push_back(CARD_WORKSHOP);
+    kingdomCards.push_back(CARD_BUREAUCRAT);
+    kingdomCards.push_back(CARD_FEAST);
+    kingdomCards.push_back(CARD_GARDENS);
+    kingdomCards.push_back(CARD_MILITIA);
+    kingdomCards.push_back(CARD_MONEYLENDER);
+    kingdomCards.push_back(CARD_REMODEL);
+    kingdomCards.push_back(CARD_SMITHY);
+    kingdomCards.push_back(CARD_SPY);
+    kingdomCards.push_back(CARD_THIEF);
+    kingdomCards.push_back(CARD_THRONEROOM);
+    kingdomCards.push_back(CARD_COUNCILROOM);
+    kingdomCards.push_back(CARD_FESTIVAL);
+    kingdomCards.push_back(CARD_LABORATORY);
+    kingdomCards.push_back(CARD_LIBRARY);
+    kingdomCards.push_back(CARD_MARKET);
+    kingdomCards.push_back(CARD_MINE);
+    kingdomCards.push_back(CARD_WITCH);
+    kingdomCards.push_back(CARD_ADVENTURER);
 
     randCards = game_state::RandomizeKingdom(kingdomCards);
+    for(size_t i = 0; i < randCards.size(); i++) {
+        for(size_t j = 0; j < i; j++) {
+            EXPECT_NE(randCards.at(i), randCards.at(j));
+        }
+    }
     EXPECT_EQ(randCards.size(), 10);
     /*for(size_t i = 0; i < randCards.size(); i++) {
-        cout << randCards.at(i).getName() << endl;
+        cout << randCards.At(i).getName() << endl;
     }*/
 }
 
+TEST(Supply, gameOverTracking) {
+    std::vector<SupplyPile> piles;
+    piles.push_back(SupplyPile(KINGDOM, CARD_VILLAGE, 1));
+    piles.push_back(SupplyPile(KINGDOM, CARD_MOAT, 1));
+    piles.push_back(SupplyPile(KINGDOM, CARD_PROVINCE, 2));
+    piles.push_back(SupplyPile(KINGDOM, CARD_MARKET, 0));
+    Supply supply(piles);
+    Pile discard = Pile(PLAYER1);
+    EXPECT_EQ(supply.GetNumEmpty(), 1);
+    supply.Take(0, &discard);
+    supply.Take(0, &discard);
+    EXPECT_EQ(supply.GetNumEmpty(), 2);
+    EXPECT_EQ(discard.Size(), 1);
+    EXPECT_FALSE(game_state::GameOver(supply));
+    supply.Take(2, &discard);
+    EXPECT_EQ(supply.Draw(2), CARD_PROVINCE);
+    EXPECT_EQ(supply.Draw(2), NO_CARD);
+    EXPECT_TRUE(supply.ProvincesGone());
+    EXPECT_TRUE(game_state::GameOver(supply));
+}
+
+TEST(Supply, registry) {
+    std::vector<SupplyPile> piles;
+    piles.push_back(SupplyPile(KINGDOM, CARD_VILLAGE, 1));
+    piles.push_back(SupplyPile(KINGDOM, CARD_MARKET, 10));
+    piles.push_back(SupplyPile(TREASURE, CARD_SILVER, 10));
+    Supply supply(piles);
+    Pile discard = Pile(PLAYER1);
+    EXPECT_EQ(supply.IndexOf(CARD_SILVER), 2);
+    EXPECT_EQ(supply.IndexOf(CARD_GOLD), CARD_NOT_FOUND);
+    EXPECT_EQ(supply.BuyableAtMost(2), 0);
+    EXPECT_EQ(supply.BuyableAtMost(3),
+              CARD_BIT(CARD_VILLAGE) | CARD_BIT(CARD_SILVER));
+    EXPECT_EQ(supply.BuyableAtMost(100), supply.BuyableAtMost(5));
+    EXPECT_TRUE(supply.CanGain(CARD_MARKET, 5));
+    EXPECT_FALSE(supply.CanGain(CARD_MARKET, 4));
+    // Emptied piles drop out of every cost bucket
+    supply.Take(supply.IndexOf(CARD_VILLAGE), &discard);
+    EXPECT_EQ(supply.BuyableAtMost(3), CARD_BIT(CARD_SILVER));
+    EXPECT_FALSE(supply.CanGain(CARD_VILLAGE, MAX_SUPPLY_COST));
+}
+
 TEST(GameState, generateKingdom) {
-    vector<Pile> kingdomCards = game_state::GenerateKingdom(randCards);
-    EXPECT_EQ(kingdomCards.size(), 10+4+3); // 10 kingdom, 4 victory, 3 treasure, 1 trash
+    Supply kingdomCards = game_state::GenerateKingdom(randCards);
+    EXPECT_EQ(kingdomCards.Size(), 10+4+3); // 10 kingdom, 4 victory, 3 treasure, 1 trash
 }
 
 TEST(GameState, scoreDeck) {
     Pile deck = Pile(PLAYER1);
-    deck.topDeck(new VictoryCard(lookup::estate));
-    deck.topDeck(new VictoryCard(lookup::estate));
-    deck.topDeck(new VictoryCard(lookup::estate));
-    deck.topDeck(new TreasureCard(lookup::copper));
-    deck.topDeck(new TreasureCard(lookup::copper));
-    deck.topDeck(new TreasureCard(lookup::copper));
-    deck.topDeck(new TreasureCard(lookup::copper));
-    deck.topDeck(new TreasureCard(lookup::copper));
-    deck.topDeck(new TreasureCard(lookup::copper));
-    deck.topDeck(new TreasureCard(lookup::copper));
-
-    EXPECT_EQ(deck.getCards().size(), 10);
+    deck.TopDeck(CARD_ESTATE);
+    deck.TopDeck(CARD_ESTATE);
+    deck.TopDeck(CARD_ESTATE);
+    deck.TopDeck(CARD_COPPER);
+    deck.TopDeck(CARD_COPPER);
+    deck.TopDeck(CARD_COPPER);
+    deck.TopDeck(CARD_COPPER);
+    deck.TopDeck(CARD_COPPER);
+    deck.TopDeck(CARD_COPPER);
+    deck.TopDeck(CARD_COPPER);
+
+    EXPECT_EQ(deck.GetCards().size(), 10);
     EXPECT_EQ(game_state::ScoreDeck(deck), 3);
-    deck.topDeck(new VictoryCard(lookup::duchy));
-    deck.topDeck(new VictoryCard(lookup::province));
+    deck.TopDeck(CARD_DUCHY);
+    deck.TopDeck(CARD_PROVINCE);
 
-    EXPECT_EQ(deck.getCards().size(), 12);
+    EXPECT_EQ(deck.GetCards().size(), 12);
     EXPECT_EQ(game_state::ScoreDeck(deck), 12);
 }
 
@@ -194,7 +570,7 @@ TEST(GameState, actionPhase) {
     Player p1 = Player(1);
     Player p2 = Player(2);
     Pile trash = Pile(TRASH);
-    std::vector<Pile> kingdomCards = game_state::GenerateKingdom(
+    Supply kingdomCards = game_state::GenerateKingdom(
                                                  lookup::GenAllCards());
     struct stateBlock state;
     state.p1 = &p1;
@@ -205,19 +581,19 @@ TEST(GameState, actionPhase) {
     // Assume phase is skipped
     game_state::ActionPhase(&state, true);
 
-    EXPECT_EQ(p1.GetHand().size(), 5);
-    EXPECT_EQ(p1.GetDeck().size(), 5);
-    EXPECT_EQ(p1.GetDiscard().size(), 0);
-    EXPECT_EQ(p2.GetHand().size(), 5);
-    EXPECT_EQ(p2.GetDeck().size(), 5);
-    EXPECT_EQ(p2.GetDiscard().size(), 0);
+    EXPECT_EQ(p1.GetHand().Size(), 5);
+    EXPECT_EQ(p1.GetDeck().Size(), 5);
+    EXPECT_EQ(p1.GetDiscard().Size(), 0);
+    EXPECT_EQ(p2.GetHand().Size(), 5);
+    EXPECT_EQ(p2.GetDeck().Size(), 5);
+    EXPECT_EQ(p2.GetDiscard().Size(), 0);
 }
 
 TEST(GameState, treasurePhase) {
     Player p1 = Player(1);
     Player p2 = Player(2);
     Pile trash = Pile(TRASH);
-    std::vector<Pile> kingdomCards = game_state::GenerateKingdom(
+    Supply kingdomCards = game_state::GenerateKingdom(
                                                  lookup::GenAllCards());
     struct stateBlock state;
     state.p1 = &p1;
@@ -228,12 +604,12 @@ TEST(GameState, treasurePhase) {
     // Assume all treasures played
     game_state::TreasurePhase(&state, true);
 
-    EXPECT_LE(p1.GetHand().size(), 4);
-    EXPECT_EQ(p1.GetDeck().size(), 5);
-    EXPECT_GE(p1.GetDiscard().size(), 1);
-    EXPECT_EQ(p2.GetHand().size(), 5);
-    EXPECT_EQ(p2.GetDeck().size(), 5);
-    EXPECT_EQ(p2.GetDiscard().size(), 0);
+    EXPECT_LE(p1.GetHand().Size(), 4);
+    EXPECT_EQ(p1.GetDeck().Size(), 5);
+    EXPECT_GE(p1.GetDiscard().Size(), 1);
+    EXPECT_EQ(p2.GetHand().Size(), 5);
+    EXPECT_EQ(p2.GetDeck().Size(), 5);
+    EXPECT_EQ(p2.GetDiscard().Size(), 0);
 
     EXPECT_GE(p1.GetCoins(), 1);
 }
@@ -243,7 +619,7 @@ TEST(GameState, buyPhase) {
     Player p1 = Player(1);
     Player p2 = Player(2);
     Pile trash = Pile(TRASH);
-    std::vector<Pile> kingdomCards = game_state::GenerateKingdom(
+    Supply kingdomCards = game_state::GenerateKingdom(
                                                  lookup::GenAllCards());
     struct stateBlock state;
     state.p1 = &p1;
@@ -254,16 +630,17 @@ TEST(GameState, buyPhase) {
     // Assume nothing is bought
     game_state::BuyPhase(&state, true);
 
-    EXPECT_EQ(p1.GetHand().size(), 5);
-    EXPECT_EQ(p1.GetDeck().size(), 5);
-    EXPECT_EQ(p1.GetDiscard().size(), 0);
-    EXPECT_EQ(p2.GetHand().size(), 5);
-    EXPECT_EQ(p2.GetDeck().size(), 5);
-    EXPECT_EQ(p2.GetDiscard().size(), 0);
+    EXPECT_EQ(p1.GetHand().Size(), 5);
+    EXPECT_EQ(p1.GetDeck().Size(), 5);
+    EXPECT_EQ(p1.GetDiscard().Size(), 0);
+    EXPECT_EQ(p2.GetHand().Size(), 5);
+    EXPECT_EQ(p2.GetDeck().Size(), 5);
+    EXPECT_EQ(p2.GetDiscard().Size(), 0);
 }
 
 TEST(RandUtils, genPseudoRandList) {
-    vector<int> pseudoRands = rand_utils::GenPseudoRandList(10, 10, rand());
+    rand_utils::Rng rng(DEF_SEED);
+    vector<int> pseudoRands = rand_utils::GenPseudoRandList(10, 10, &rng);
     EXPECT_EQ(pseudoRands.size(), 10);
     for(size_t i = 0; i < pseudoRands.size(); i++) {
         for(size_t j = 0; j < pseudoRands.size(); j++) {
@@ -274,6 +651,46 @@ TEST(RandUtils, genPseudoRandList) {
     }
 }
 
+TEST(RandUtils, seededSequence) {
+    rand_utils::Rng rng1(42);
+    rand_utils::Rng rng2(42);
+    rand_utils::Rng rng3(43);
+    bool differs = false;
+    for(int i = 0; i < 100; i++) {
+        uint64_t val = rng1.Next();
+        EXPECT_EQ(val, rng2.Next());
+        differs = differs || val != rng3.Next();
+    }
+    EXPECT_TRUE(differs);
+    for(int i = 0; i < 100; i++) {
+        EXPECT_LT(rng1.Below(7), 7);
+    }
+}
+
+TEST(RandUtils, streams) {
+    rand_utils::Rng game3(42, 3);
+    rand_utils::Rng game3Again(42, 3);
+    rand_utils::Rng game4(42, 4);
+    bool streamsDiffer = false;
+    for(int i = 0; i < 100; i++) {
+        uint64_t val = game3.Next();
+        EXPECT_EQ(val, game3Again.Next());
+        streamsDiffer = streamsDiffer || val != game4.Next();
+    }
+    EXPECT_TRUE(streamsDiffer);
+}
+
+TEST(CardLookup, findCard) {
+    for(CardId id = 0; id < NUM_CARDS; id++) {
+        EXPECT_EQ(lookup::FindCard(lookup::GetCard(id).GetName()), id);
+    }
+    EXPECT_EQ(lookup::FindCard("throneroom"), CARD_THRONEROOM);
+    EXPECT_EQ(lookup::FindCard(""), NO_CARD);
+    EXPECT_EQ(lookup::FindCard("gol"), NO_CARD);
+    EXPECT_EQ(lookup::FindCard("golden"), NO_CARD);
+    EXPECT_EQ(lookup::FindCard("Gold"), NO_CARD);
+}
+
 TEST(CardLookup, cellarEffect) {
     struct stateBlock state;
     Player p1 = Player(1);
@@ -281,9 +698,9 @@ TEST(CardLookup, cellarEffect) {
 
     lookup::CellarEffect(&state, true);
 
-    EXPECT_EQ(p1.GetHand().size(), 5);
-    EXPECT_EQ(p1.GetDiscard().size(), 5);
-    EXPECT_EQ(p1.GetDeck().size(), 0);
+    EXPECT_EQ(p1.GetHand().Size(), 5);
+    EXPECT_EQ(p1.GetDiscard().Size(), 5);
+    EXPECT_EQ(p1.GetDeck().Size(), 0);
 }
 
 TEST(CardLookup, chapelEffect) {
@@ -295,8 +712,8 @@ TEST(CardLookup, chapelEffect) {
 
     lookup::ChapelEffect(&state, true);
 
-    EXPECT_EQ(p1.GetHand().size(), 1);
-    EXPECT_EQ(trash.size(), 4);
+    EXPECT_EQ(p1.GetHand().Size(), 1);
+    EXPECT_EQ(trash.Size(), 4);
 }
 
 TEST(CardLookup, chancellorEffect) {
@@ -306,31 +723,31 @@ TEST(CardLookup, chancellorEffect) {
     // deck->discard
     lookup::ChancellorEffect(&state, true);
 
-    EXPECT_EQ(p1.GetDeck().size(), 0);
-    EXPECT_EQ(p1.GetDiscard().size(), 5);
+    EXPECT_EQ(p1.GetDeck().Size(), 0);
+    EXPECT_EQ(p1.GetDiscard().Size(), 5);
 
     p1 = Player(1);
     state.p1 = &p1;
     // don't deck->discard
     lookup::ChancellorEffect(&state, true);
 
-    EXPECT_EQ(p1.GetDeck().size(), 5);
-    EXPECT_EQ(p1.GetDiscard().size(), 0);
+    EXPECT_EQ(p1.GetDeck().Size(), 5);
+    EXPECT_EQ(p1.GetDiscard().Size(), 0);
 }
 
 TEST(CardLookup, workshopEffect) {
-    Pile chapels = Pile(KINGDOM, (Card)lookup::chapel, 10);
-    Pile moats = Pile(KINGDOM, (Card)lookup::moat, 10);
-    Pile chancellors = Pile(KINGDOM, (Card)lookup::chancellor, 10);
-    Pile woodcutters = Pile(KINGDOM, (Card)lookup::woodcutter, 10);
-    Pile workshops = Pile(KINGDOM, (Card)lookup::workshop, 10);
-    Pile thiefs = Pile(KINGDOM, (Card)lookup::thief , 10);
-    Pile councilrooms = Pile(KINGDOM, (Card)lookup::councilroom, 10);
-    Pile markets = Pile(KINGDOM, (Card)lookup::market, 10);
-    Pile mines = Pile(KINGDOM, (Card)lookup::mine, 10);
-    Pile adventurers = Pile(KINGDOM, (Card)lookup::adventurer, 10);
-
-    std::vector<Pile> kingdomPiles;
+    SupplyPile chapels = SupplyPile(KINGDOM, CARD_CHAPEL, 10);
+    SupplyPile moats = SupplyPile(KINGDOM, CARD_MOAT, 10);
+    SupplyPile chancellors = SupplyPile(KINGDOM, CARD_CHANCELLOR, 10);
+    SupplyPile woodcutters = SupplyPile(KINGDOM, CARD_WOODCUTTER, 10);
+    SupplyPile workshops = SupplyPile(KINGDOM, CARD_WORKSHOP, 10);
+    SupplyPile thiefs = SupplyPile(KINGDOM, CARD_THIEF , 10);
+    SupplyPile councilrooms = SupplyPile(KINGDOM, CARD_COUNCILROOM, 10);
+    SupplyPile markets = SupplyPile(KINGDOM, CARD_MARKET, 10);
+    SupplyPile mines = SupplyPile(KINGDOM, CARD_MINE, 10);
+    SupplyPile adventurers = SupplyPile(KINGDOM, CARD_ADVENTURER, 10);
+
+    std::vector<SupplyPile> kingdomPiles;
     kingdomPiles.push_back(chapels);
     kingdomPiles.push_back(moats);
     kingdomPiles.push_back(chancellors);
@@ -341,31 +758,32 @@ TEST(CardLookup, workshopEffect) {
     kingdomPiles.push_back(markets);
     kingdomPiles.push_back(mines);
     kingdomPiles.push_back(adventurers);
+    Supply supply(kingdomPiles);
 
     Player p1 = Player(1);
     struct stateBlock state;
     state.p1 = &p1;
-    state.kingdom = &kingdomPiles;
+    state.kingdom = &supply;
 
     lookup::WorkshopEffect(&state, true);
 
-    EXPECT_EQ(kingdomPiles.size(), 10);
-    EXPECT_EQ(kingdomPiles.at(1).size(), 9);
-    EXPECT_EQ(p1.GetDiscard().size(), 1);
+    EXPECT_EQ(supply.Size(), 10);
+    EXPECT_EQ(supply.At(1).Size(), 9);
+    EXPECT_EQ(p1.GetDiscard().Size(), 1);
 
     lookup::WorkshopEffect(&state, true);
-    EXPECT_EQ(kingdomPiles.size(), 10);
-    EXPECT_EQ(kingdomPiles.at(1).size(), 8);
-    EXPECT_EQ(p1.GetDiscard().size(), 2);
+    EXPECT_EQ(supply.Size(), 10);
+    EXPECT_EQ(supply.At(1).Size(), 8);
+    EXPECT_EQ(p1.GetDiscard().Size(), 2);
 
     lookup::WorkshopEffect(&state, true);
-    EXPECT_EQ(kingdomPiles.size(), 10);
-    EXPECT_EQ(kingdomPiles.at(5).size(), 9);
-    EXPECT_EQ(p1.GetDiscard().size(), 3);
+    EXPECT_EQ(supply.Size(), 10);
+    EXPECT_EQ(supply.At(5).Size(), 9);
+    EXPECT_EQ(p1.GetDiscard().Size(), 3);
 }
 
 TEST(CardLookup, bureaucratEffect) {
-    std::vector<Pile> kingdomCards = game_state::GenerateKingdom(
+    Supply kingdomCards = game_state::GenerateKingdom(
                                                  lookup::GenAllCards());
     Player p1 = Player(1);
     Player p2 = Player(2);
@@ -376,16 +794,16 @@ TEST(CardLookup, bureaucratEffect) {
 
     lookup::BureaucratEffect(&state, true);
 
-    EXPECT_EQ(p1.GetDeck().getTopCard()->GetName(), "silver");
-    EXPECT_EQ(p1.GetDeck().size(), 6);
-    EXPECT_EQ(p2.GetHand().size(), 4);
-    EXPECT_EQ(p2.GetDeck().size(), 6);
-    EXPECT_EQ(p2.GetDeck().getTopCard()->GetName(), "estate");
+    EXPECT_EQ(p1.GetDeck().GetTopCard(), CARD_SILVER);
+    EXPECT_EQ(p1.GetDeck().Size(), 6);
+    EXPECT_EQ(p2.GetHand().Size(), 4);
+    EXPECT_EQ(p2.GetDeck().Size(), 6);
+    EXPECT_EQ(p2.GetDeck().GetTopCard(), CARD_ESTATE);
 }
 
 TEST(CardLookup, feastEffect) {
     Player p1 = Player(1);
-    std::vector<Pile> kingdomCards = game_state::GenerateKingdom(
+    Supply kingdomCards = game_state::GenerateKingdom(
                                                  lookup::GenAllCards());
     Pile trash = Pile(TRASH);
     struct stateBlock state;
@@ -393,12 +811,12 @@ TEST(CardLookup, feastEffect) {
     state.kingdom = &kingdomCards;
     state.trash = &trash;
 
-    bool trashed = lookup::FeastEffect(&state, true);
+    bool trashed = lookup::FeastEffect(&state, true).Get();
 
-    EXPECT_EQ(p1.GetDiscard().size(), 1);
-    EXPECT_LE(p1.GetDiscard().getTopCard()->GetCost(), 5);
+    EXPECT_EQ(p1.GetDiscard().Size(), 1);
+    EXPECT_LE(lookup::GetCard(p1.GetDiscard().GetTopCard()).GetCost(), 5);
     EXPECT_EQ(trashed, true);
-    EXPECT_EQ(p1.GetHand().size(), 5);
+    EXPECT_EQ(p1.GetHand().Size(), 5);
 }
 
 TEST(CardLookup, militiaEffect) {
@@ -408,7 +826,7 @@ TEST(CardLookup, militiaEffect) {
     state.p1 = &p1;
     state.p2 = &p2;
     lookup::MilitiaEffect(&state, true);
-    EXPECT_EQ(p2.GetHand().size(), 3);
+    EXPECT_EQ(p2.GetHand().Size(), 3);
 }
 
 TEST(CardLookup, moneylenderEffect) {
@@ -419,13 +837,13 @@ TEST(CardLookup, moneylenderEffect) {
     state.trash = &trash;
     lookup::MoneylenderEffect(&state, true);
     EXPECT_EQ(p1.GetCoins(), 3);
-    EXPECT_EQ(p1.GetHand().size(), 4);
+    EXPECT_EQ(p1.GetHand().Size(), 4);
 }
 
 TEST(CardLookup, remodelEffect) {
     Player p1 = Player(1);
     Pile trash = Pile(TRASH);
-    std::vector<Pile> kingdomCards = game_state::GenerateKingdom(
+    Supply kingdomCards = game_state::GenerateKingdom(
                                                  lookup::GenAllCards());
     struct stateBlock state;
     state.p1 = &p1;
@@ -435,11 +853,11 @@ TEST(CardLookup, remodelEffect) {
     // Assume we trash an estate
     lookup::RemodelEffect(&state, true);
 
-    EXPECT_LE(p1.GetHand().getTopCard()->GetCost(), 4);
-    EXPECT_EQ(p1.GetHand().size(), 4);
-    EXPECT_EQ(p1.GetDiscard().size(), 1);
-    EXPECT_EQ(p1.GetDeck().size(), 5);
-    EXPECT_EQ(trash.size(), 1);
+    EXPECT_LE(lookup::GetCard(p1.GetHand().GetTopCard()).GetCost(), 4);
+    EXPECT_EQ(p1.GetHand().Size(), 4);
+    EXPECT_EQ(p1.GetDiscard().Size(), 1);
+    EXPECT_EQ(p1.GetDeck().Size(), 5);
+    EXPECT_EQ(trash.Size(), 1);
 }
 
 TEST(CardLookup, spyEffect) {
@@ -452,21 +870,21 @@ TEST(CardLookup, spyEffect) {
 
     // Don't discard either card
     lookup::SpyEffect(&state, true);
-    EXPECT_EQ(p1.GetDeck().size(), 5);
-    EXPECT_EQ(p1.GetDiscard().size(), 0);
-    EXPECT_EQ(p1.GetHand().size(), 5);
-    EXPECT_EQ(p2.GetDeck().size(), 5);
-    EXPECT_EQ(p2.GetDiscard().size(), 0);
-    EXPECT_EQ(p2.GetHand().size(), 5);
+    EXPECT_EQ(p1.GetDeck().Size(), 5);
+    EXPECT_EQ(p1.GetDiscard().Size(), 0);
+    EXPECT_EQ(p1.GetHand().Size(), 5);
+    EXPECT_EQ(p2.GetDeck().Size(), 5);
+    EXPECT_EQ(p2.GetDiscard().Size(), 0);
+    EXPECT_EQ(p2.GetHand().Size(), 5);
 
     // Discard both cards
     lookup::SpyEffect(&state, true);
-    EXPECT_EQ(p1.GetDeck().size(), 4);
-    EXPECT_EQ(p1.GetDiscard().size(), 1);
-    EXPECT_EQ(p1.GetHand().size(), 5);
-    EXPECT_EQ(p2.GetDeck().size(), 4);
-    EXPECT_EQ(p2.GetDiscard().size(), 1);
-    EXPECT_EQ(p2.GetHand().size(), 5);
+    EXPECT_EQ(p1.GetDeck().Size(), 4);
+    EXPECT_EQ(p1.GetDiscard().Size(), 1);
+    EXPECT_EQ(p1.GetHand().Size(), 5);
+    EXPECT_EQ(p2.GetDeck().Size(), 4);
+    EXPECT_EQ(p2.GetDiscard().Size(), 1);
+    EXPECT_EQ(p2.GetHand().Size(), 5);
 }
 
 TEST(CardLookup, thiefEffect) {
@@ -480,44 +898,44 @@ TEST(CardLookup, thiefEffect) {
     p2.DrawCard();
     p2.DrawCard();
     p2.DrawCard();
-    p2.AddToDeck(new Card(lookup::copper));
-    p2.AddToDeck(new Card(lookup::copper));
-    p2.AddToDeck(new Card(lookup::copper));
-    p2.AddToDeck(new Card(lookup::copper));
-    p2.AddToDeck(new Card(lookup::copper));
-    p2.AddToDeck(new Card(lookup::copper));
-    p2.AddToDeck(new Card(lookup::copper));
-    p2.AddToDeck(new Card(lookup::copper));
-    p2.AddToDeck(new Card(lookup::copper));
-    p2.AddToDeck(new Card(lookup::copper));
+    p2.AddToDeck(CARD_COPPER);
+    p2.AddToDeck(CARD_COPPER);
+    p2.AddToDeck(CARD_COPPER);
+    p2.AddToDeck(CARD_COPPER);
+    p2.AddToDeck(CARD_COPPER);
+    p2.AddToDeck(CARD_COPPER);
+    p2.AddToDeck(CARD_COPPER);
+    p2.AddToDeck(CARD_COPPER);
+    p2.AddToDeck(CARD_COPPER);
+    p2.AddToDeck(CARD_COPPER);
 
     state.p1 = &p1;
     state.p2 = &p2;
     state.trash = &trash;
 
-    EXPECT_EQ(p2.GetDiscard().size(), 0);
+    EXPECT_EQ(p2.GetDiscard().Size(), 0);
     // Trash first card, discard 2nd, take trashed
     lookup::ThiefEffect(&state, true);
 
-    EXPECT_EQ(trash.size(), 0);
-    EXPECT_EQ(p2.GetDiscard().size(), 1);
-    EXPECT_EQ(p2.GetDeck().size(), 8);
-    EXPECT_EQ(p1.GetDiscard().size(), 1);
+    EXPECT_EQ(trash.Size(), 0);
+    EXPECT_EQ(p2.GetDiscard().Size(), 1);
+    EXPECT_EQ(p2.GetDeck().Size(), 8);
+    EXPECT_EQ(p1.GetDiscard().Size(), 1);
 
     // Trash 2nd card, discard 1st, take trashed
     lookup::ThiefEffect(&state, true);
 
-    EXPECT_EQ(trash.size(), 0);
-    EXPECT_EQ(p2.GetDiscard().size(), 2);
-    EXPECT_EQ(p2.GetDeck().size(), 6);
-    EXPECT_EQ(p1.GetDiscard().size(), 2);
+    EXPECT_EQ(trash.Size(), 0);
+    EXPECT_EQ(p2.GetDiscard().Size(), 2);
+    EXPECT_EQ(p2.GetDeck().Size(), 6);
+    EXPECT_EQ(p1.GetDiscard().Size(), 2);
 
     // Trash 1st card, discard 2nd, take nothing
     lookup::ThiefEffect(&state, true);
-    EXPECT_EQ(trash.size(), 1);
-    EXPECT_EQ(p2.GetDiscard().size(), 3);
-    EXPECT_EQ(p2.GetDeck().size(), 4);
-    EXPECT_EQ(p1.GetDiscard().size(), 2);
+    EXPECT_EQ(trash.Size(), 1);
+    EXPECT_EQ(p2.GetDiscard().Size(), 3);
+    EXPECT_EQ(p2.GetDeck().Size(), 4);
+    EXPECT_EQ(p1.GetDiscard().Size(), 2);
 }
 
 TEST(CardLookup, throneroomEffect) {
@@ -525,18 +943,16 @@ TEST(CardLookup, throneroomEffect) {
     Player p1 = Player(1);
     Player p2 = Player(2);
 
-    Card *tmpCard = new ActionCard(lookup::councilroom);
-    tmpCard->SetEffect(lookup::CouncilroomEffect);
-    p1.AddToHand(tmpCard);
-    EXPECT_EQ(p1.GetHand().size(), 6);
+    p1.AddToHand(CARD_COUNCILROOM);
+    EXPECT_EQ(p1.GetHand().Size(), 6);
 
 
     state.p1 = &p1;
     state.p2 = &p2;
     lookup::ThroneroomEffect(&state, true);
 
-    EXPECT_EQ(p1.GetHand().size(), 10);
-    EXPECT_EQ(p2.GetHand().size(), 7);
+    EXPECT_EQ(p1.GetHand().Size(), 10);
+    EXPECT_EQ(p2.GetHand().Size(), 7);
 }
 
 TEST(CardLookup, councilroomEffect) {
@@ -549,30 +965,30 @@ TEST(CardLookup, councilroomEffect) {
 
     lookup::CouncilroomEffect(&state, true);
 
-    EXPECT_EQ(p2.GetHand().size(), 6);
-    EXPECT_EQ(p2.GetDeck().size(), 4);
-    EXPECT_EQ(p2.GetDiscard().size(), 0);
+    EXPECT_EQ(p2.GetHand().Size(), 6);
+    EXPECT_EQ(p2.GetDeck().Size(), 4);
+    EXPECT_EQ(p2.GetDiscard().Size(), 0);
 }
 
 TEST(CardLookup, libraryEffect) {
     struct stateBlock state;
     Player p1 = Player(1);
-    p1.AddToDeck(new Card(lookup::adventurer));
-    p1.AddToDeck(new Card(lookup::village));
-    p1.AddToDeck(new Card(lookup::gold));
-    p1.AddToDeck(new Card(lookup::chapel));
-    p1.AddToDeck(new Card(lookup::silver));
+    p1.AddToDeck(CARD_ADVENTURER);
+    p1.AddToDeck(CARD_VILLAGE);
+    p1.AddToDeck(CARD_GOLD);
+    p1.AddToDeck(CARD_CHAPEL);
+    p1.AddToDeck(CARD_SILVER);
 
     state.p1 = &p1;
     lookup::LibraryEffect(&state, true);
 
     // Assume we set aside the chapel
-    EXPECT_EQ(p1.GetHand().size(), 7);
-    EXPECT_EQ(p1.GetHand().at(6)->GetName(), "gold");
-    EXPECT_EQ(p1.GetHand().at(5)->GetName(), "silver");
+    EXPECT_EQ(p1.GetHand().Size(), 7);
+    EXPECT_EQ(p1.GetHand().At(6), CARD_GOLD);
+    EXPECT_EQ(p1.GetHand().At(5), CARD_SILVER);
 
-    EXPECT_EQ(p1.GetDiscard().size(), 1);
-    EXPECT_EQ(p1.GetDiscard().getTopCard()->GetName(), "chapel");
+    EXPECT_EQ(p1.GetDiscard().Size(), 1);
+    EXPECT_EQ(p1.GetDiscard().GetTopCard(), CARD_CHAPEL);
 
 }
 
@@ -581,28 +997,28 @@ TEST(CardLookup, mineEffect) {
     struct stateBlock state;
     Player p1 = Player(1);
     Pile trash = Pile(TRASH);
-    p1.AddToHand(new Card(lookup::copper));
-    std::vector<Pile> kingdomCards = game_state::GenerateKingdom(
+    p1.AddToHand(CARD_COPPER);
+    Supply kingdomCards = game_state::GenerateKingdom(
                                                  lookup::GenAllCards());
-    EXPECT_EQ(p1.GetHand().size(), 6);
+    EXPECT_EQ(p1.GetHand().Size(), 6);
     state.p1 = &p1;
     state.kingdom = &kingdomCards;
     state.trash = &trash;
 
     // Trash a copper and take a silver
     lookup::MineEffect(&state, true);
-    EXPECT_EQ(p1.GetHand().size(), 6);
-    EXPECT_EQ(trash.size(), 1);
-    int cardIdx = p1.GetHand().lookThrough(new Card(lookup::silver));
+    EXPECT_EQ(p1.GetHand().Size(), 6);
+    EXPECT_EQ(trash.Size(), 1);
+    int cardIdx = p1.GetHand().LookThrough(CARD_SILVER);
     EXPECT_GT(cardIdx, -1);
 
     // Trash a silver and take a gold
     lookup::MineEffect(&state, true);
-    EXPECT_EQ(p1.GetHand().size(), 6);
-    EXPECT_EQ(trash.size(), 2);
-    cardIdx = p1.GetHand().lookThrough(new Card(lookup::silver));
+    EXPECT_EQ(p1.GetHand().Size(), 6);
+    EXPECT_EQ(trash.Size(), 2);
+    cardIdx = p1.GetHand().LookThrough(CARD_SILVER);
     EXPECT_EQ(cardIdx, -1);
-    cardIdx = p1.GetHand().lookThrough(new Card(lookup::gold));
+    cardIdx = p1.GetHand().LookThrough(CARD_GOLD);
     EXPECT_GT(cardIdx, -1);
 
 }
@@ -612,14 +1028,14 @@ TEST(CardLookup, witchEffect) {
     Player p1 = Player(1);
     Player p2 = Player(2);
 
-    std::vector<Pile> kingdomCards = game_state::GenerateKingdom(
+    Supply kingdomCards = game_state::GenerateKingdom(
                                                  lookup::GenAllCards());
     state.p1 = &p1;
     state.p2 = &p2;
     state.kingdom = &kingdomCards;
     lookup::WitchEffect(&state, true);
-    EXPECT_EQ(p2.GetDiscard().size(), 1);
-    EXPECT_EQ(p2.GetDiscard().getTopCard()->GetName(), "curse");
+    EXPECT_EQ(p2.GetDiscard().Size(), 1);
+    EXPECT_EQ(p2.GetDiscard().GetTopCard(), CARD_CURSE);
 }
 
 TEST(CardLookup, adventurerEffect) {
@@ -628,38 +1044,1404 @@ TEST(CardLookup, adventurerEffect) {
     for(int i = 0; i < 5; i++) {
         p1.DiscardCard(0);
     }
-    EXPECT_EQ(p1.GetDeck().size(), 5);
-    p1.AddToDeck(new Card(lookup::silver));
-    p1.AddToDeck(new Card(lookup::estate));
-    p1.AddToDeck(new Card(lookup::estate));
-    p1.AddToDeck(new Card(lookup::estate));
-    p1.AddToDeck(new Card(lookup::gold));
+    EXPECT_EQ(p1.GetDeck().Size(), 5);
+    p1.AddToDeck(CARD_SILVER);
+    p1.AddToDeck(CARD_ESTATE);
+    p1.AddToDeck(CARD_ESTATE);
+    p1.AddToDeck(CARD_ESTATE);
+    p1.AddToDeck(CARD_GOLD);
+
+    EXPECT_EQ(p1.GetDeck().Size(), 10);
+    EXPECT_EQ(p1.GetHand().Size(), 0);
+    EXPECT_EQ(p1.GetDiscard().Size(), 5);
+
+    state.p1 = &p1;
+
+    lookup::AdventurerEffect(&state, true);
+    EXPECT_EQ(p1.GetHand().Size(), 2);
+    EXPECT_EQ(p1.GetDeck().Size(), 5);
+    EXPECT_EQ(p1.GetHand().At(0), CARD_GOLD);
+    EXPECT_EQ(p1.GetHand().At(1), CARD_SILVER);
+}
 
-    EXPECT_EQ(p1.GetDeck().size(), 10);
-    EXPECT_EQ(p1.GetHand().size(), 0);
-    EXPECT_EQ(p1.GetDiscard().size(), 5);
+TEST(CardLookup, adventurerShortOfTreasure) {
+    // One treasure across deck and discard: Adventurer takes it and
+    // stops once both are exhausted, discarding what it revealed
+    struct stateBlock state;
+    Player p1 = Player(1);
+    p1.HandPtr()->EmptyDeck();
+    p1.DeckPtr()->EmptyDeck();
+    p1.AddToDeck(CARD_ESTATE);
+    p1.AddToDeck(CARD_COPPER);
+    p1.AddToDeck(CARD_ESTATE);
+    p1.AddToDiscard(CARD_DUCHY);
+    state.p1 = &p1;
 
+    lookup::AdventurerEffect(&state, true);
+    EXPECT_EQ(p1.GetHand().GetCards(), vector<CardId>({CARD_COPPER}));
+    EXPECT_EQ(p1.GetDeck().Size(), 0);
+    EXPECT_EQ(p1.GetDiscard().Count(CARD_ESTATE), 2);
+    EXPECT_EQ(p1.GetDiscard().Count(CARD_DUCHY), 1);
+    EXPECT_EQ(p1.GetNumCards(), 4);
+}
+
+TEST(CardLookup, adventurerReshuffles) {
+    // An empty deck is reshuffled from the discard pile, but the cards
+    // revealed before then are set aside and not drawn again
+    struct stateBlock state;
+    Player p1 = Player(1);
+    p1.HandPtr()->EmptyDeck();
+    p1.DeckPtr()->EmptyDeck();
+    p1.AddToDeck(CARD_ESTATE);
+    p1.AddToDiscard(CARD_SILVER);
+    p1.AddToDiscard(CARD_GOLD);
     state.p1 = &p1;
 
     lookup::AdventurerEffect(&state, true);
-    EXPECT_EQ(p1.GetHand().size(), 2);
-    EXPECT_EQ(p1.GetDeck().size(), 5);
-    EXPECT_EQ(p1.GetHand().at(0)->GetName(), "gold");
-    EXPECT_EQ(p1.GetHand().at(1)->GetName(), "silver");
+    EXPECT_EQ(p1.GetHand().Size(), 2);
+    EXPECT_EQ(p1.GetHand().Count(CARD_SILVER), 1);
+    EXPECT_EQ(p1.GetHand().Count(CARD_GOLD), 1);
+    EXPECT_EQ(p1.GetDeck().Size(), 0);
+    EXPECT_EQ(p1.GetDiscard().GetCards(), vector<CardId>({CARD_ESTATE}));
+}
+
+TEST(Decision, botChapel) {
+    ChapelBot bot;
+    struct stateBlock state;
+    Player p1 = Player(1);
+    Pile trash = Pile(TRASH);
+    state.p1 = &p1;
+    state.trash = &trash;
+    state.p1Decider = &bot;
+    int numEstates = p1.GetHand().Count(CARD_ESTATE);
+
+    lookup::ChapelEffect(&state, true);
+
+    EXPECT_FALSE(p1.GetHand().Contains(CARD_ESTATE));
+    EXPECT_EQ(p1.GetHand().Size(), 5 - numEstates);
+    EXPECT_EQ(trash.Count(CARD_ESTATE), numEstates);
+}
+
+TEST(Decision, botCellarReshuffles) {
+    // Cellar draws like any other draw: once the deck runs out, the
+    // discard pile (cards just discarded included) is shuffled into it
+    CellarBot bot;
+    struct stateBlock state;
+    Player p1 = Player(1);
+    state.p1 = &p1;
+    state.p1Decider = &bot;
+    p1.DiscardPtr()->TakeAllFrom(p1.DeckPtr());
+
+    lookup::CellarEffect(&state, true);
+
+    EXPECT_EQ(p1.GetHand().Size(), 5);
+    EXPECT_EQ(p1.GetDeck().Size(), 5);
+    EXPECT_EQ(p1.GetDiscard().Size(), 0);
+    EXPECT_EQ(p1.GetNumCards(), 10);
+}
+
+TEST(Decision, botMilitia) {
+    // The attacked player's decider makes the discards
+    BotDecider bot;
+    struct stateBlock state;
+    Player p1 = Player(1);
+    Player p2 = Player(2);
+    state.p1 = &p1;
+    state.p2 = &p2;
+    state.p2Decider = &bot;
+
+    lookup::MilitiaEffect(&state, true);
+
+    EXPECT_EQ(p2.GetHand().Size(), 3);
+    EXPECT_EQ(p2.GetDiscard().Size(), 2);
+}
+
+TEST(Decision, illegalAnswersAreChecked) {
+    LiarBot bot;
+    Player p1 = Player(1);
+    Pile trash = Pile(TRASH);
+    Supply kingdomCards = game_state::GenerateKingdom(
+                                                 lookup::GenAllCards());
+    struct stateBlock state;
+    state.p1 = &p1;
+    state.trash = &trash;
+    state.kingdom = &kingdomCards;
+    state.p1Decider = &bot;
+
+    // Out-of-range answers fall back to the first legal option
+    lookup::RemodelEffect(&state, true);
+    EXPECT_EQ(p1.GetHand().Size(), 4);
+    EXPECT_EQ(trash.Size(), 1);
+    EXPECT_EQ(p1.GetDiscard().Size(), 1);
+
+    // Bad and repeated picks are dropped
+    lookup::ChapelEffect(&state, true);
+    EXPECT_EQ(p1.GetHand().Size(), 3);
+    EXPECT_EQ(trash.Size(), 2);
+
+    // Nothing to play means nothing is asked
+    p1.DiscardPtr()->TakeAllFrom(p1.HandPtr());
+    EXPECT_EQ(decision::FromHand(state, true, DEC_THRONEROOM, p1.GetHand(),
+                                 lookup::ACTION_CARDS, false).Get(),
+              DEF_CHOICE);
+}
+
+TEST(Decision, botGame) {
+    vector<CardId> cardSet = {CARD_CELLAR, CARD_CHAPEL, CARD_WORKSHOP,
+                              CARD_FEAST, CARD_MILITIA, CARD_MONEYLENDER,
+                              CARD_REMODEL, CARD_THRONEROOM, CARD_LIBRARY,
+                              CARD_MINE};
+    GameArena arena;
+    int turns = PlayBotGame(&arena, 77, cardSet);
+    EXPECT_LT(turns, MAX_ARENA_TURNS);
+    EXPECT_TRUE(game_state::GameOver(*arena.GetState()->kingdom));
+    int p1Score = arena.GetState()->p1->GetScore();
+    int p2Score = arena.GetState()->p2->GetScore();
+
+    // No I/O means the seed alone decides the game
+    EXPECT_EQ(PlayBotGame(&arena, 77, cardSet), turns);
+    EXPECT_EQ(arena.GetState()->p1->GetScore(), p1Score);
+    EXPECT_EQ(arena.GetState()->p2->GetScore(), p2Score);
+}
+
+TEST(Decision, botGamesEveryKingdom) {
+    // Bots play every action they hold, so with played cards anywhere a
+    // draw could reach, a Village or Smithy could be drawn and played
+    // again within one turn forever. Kept in play, every turn ends.
+    GameArena arena;
+    for(int seed = 0; seed < NUM_BOT_SEEDS; seed++) {
+        int turns = PlayBotGame(&arena, seed, lookup::GenAllCards());
+        EXPECT_LE(turns, MAX_ARENA_TURNS);
+        struct stateBlock *state = arena.GetState();
+        EXPECT_EQ(state->p1->GetInPlay().Size(), 0);
+        EXPECT_EQ(state->p2->GetInPlay().Size(), 0);
+    }
+}
+
+TEST(Decision, autoResolveSameGameFewerQuestions) {
+    vector<CardId> cardSet = {CARD_CELLAR, CARD_CHAPEL, CARD_WORKSHOP,
+                              CARD_FEAST, CARD_MILITIA, CARD_MONEYLENDER,
+                              CARD_REMODEL, CARD_THRONEROOM, CARD_SPY,
+                              CARD_THIEF};
+    GameArena arena;
+    CountingBot asked1, asked2;
+    int turns = PlayBotGame(&arena, 31, cardSet, &asked1, &asked2);
+    int p1Score = arena.GetState()->p1->GetScore();
+    int p2Score = arena.GetState()->p2->GetScore();
+
+    // Bots already take the forced answer and play every treasure, so
+    // answering for them changes nothing but how often they're asked
+    arena.SetAutoResolve(true);
+    arena.SetAutoTreasures(true);
+    CountingBot auto1, auto2;
+    EXPECT_EQ(PlayBotGame(&arena, 31, cardSet, &auto1, &auto2), turns);
+    arena.SetAutoResolve(false);
+    arena.SetAutoTreasures(false);
+    EXPECT_EQ(arena.GetState()->p1->GetScore(), p1Score);
+    EXPECT_EQ(arena.GetState()->p2->GetScore(), p2Score);
+    EXPECT_EQ(auto1.asked[DEC_PLAY_TREASURE], 0);
+    EXPECT_LE(auto1.asked[DEC_PLAY_ACTION], asked1.asked[DEC_PLAY_ACTION]);
+    EXPECT_LT(2 * (auto1.Total() + auto2.Total()),
+              asked1.Total() + asked2.Total());
+}
+
+TEST(Decision, autoResolveForcedChoices) {
+    CountingBot bot;
+    struct stateBlock state;
+    Player p1 = Player(1);
+    state.p1 = &p1;
+    state.p2 = &p1;
+    state.p1Decider = &bot;
+    state.autoResolve = true;
+    p1.HandPtr()->EmptyDeck();
+    p1.AddToHand(CARD_ESTATE);
+    p1.AddToHand(CARD_COPPER);
+    p1.AddToHand(CARD_COPPER);
+    p1.AddToHand(CARD_COPPER);
+    // No action to play: declined without asking
+    EXPECT_EQ(decision::FromHand(state, true, DEC_PLAY_ACTION, p1.GetHand(),
+                                 lookup::ACTION_CARDS, true).Get(),
+              DEF_CHOICE);
+    // One kind and no way out: taken without asking
+    EXPECT_EQ(decision::FromHand(state, true, DEC_REMODEL_TRASH,
+                                 p1.GetHand(), CARD_BIT(CARD_ESTATE),
+                                 false).Get(), 0);
+    // Two of three identical coppers: any two will do
+    std::vector<int> picks;
+    decision::ManyFromHand(state, true, DEC_MILITIA, p1.GetHand(),
+                           lookup::TREASURE_CARDS, 2, 2, &picks);
+    EXPECT_EQ(picks, std::vector<int>({2, 1}));
+    EXPECT_EQ(bot.Total(), 0);
+    // A real choice is still asked
+    decision::ManyFromHand(state, true, DEC_MILITIA, p1.GetHand(),
+                           ALL_CARDS, 2, 2, &picks);
+    EXPECT_EQ(bot.asked[DEC_MILITIA], 1);
+}
+
+TEST(Decision, spyAndThiefOnEmptyDecks) {
+    CountingBot bot;
+    struct stateBlock state;
+    Player p1 = Player(1);
+    Player p2 = Player(2);
+    Pile trash = Pile(TRASH);
+    state.p1 = &p1;
+    state.p2 = &p2;
+    state.trash = &trash;
+    state.p1Decider = &bot;
+    p1.DeckPtr()->EmptyDeck();
+    p2.DeckPtr()->EmptyDeck();
+    p2.DiscardPtr()->EmptyDeck();
+    lookup::SpyEffect(&state, true);
+    lookup::ThiefEffect(&state, true);
+    EXPECT_EQ(bot.Total(), 0);
+    EXPECT_EQ(p2.GetDiscard().Size(), 0);
+    EXPECT_EQ(trash.Size(), 0);
+}
+
+TEST(Decision, spyOnEmptyDeck) {
+    // Only the deck that reveals a card is asked about
+    CountingBot bot;
+    struct stateBlock state;
+    Player p1 = Player(1);
+    Player p2 = Player(2);
+    state.p1 = &p1;
+    state.p2 = &p2;
+    state.p1Decider = &bot;
+    p1.DeckPtr()->EmptyDeck();
+    p2.DeckPtr()->EmptyDeck();
+    p2.AddToDeck(CARD_GOLD);
+    lookup::SpyEffect(&state, true);
+    EXPECT_EQ(bot.asked[DEC_SPY_SELF], 0);
+    EXPECT_EQ(bot.asked[DEC_SPY_OTHER], 1);
+    EXPECT_EQ(p1.GetDeck().Size(), 0);
+    EXPECT_EQ(p2.GetDeck().GetTopCard(), CARD_GOLD);
+}
+
+TEST(Decision, thiefOnShortDeck) {
+    // A deck of one reveals one card, and only it reaches the discard
+    CountingBot bot;
+    struct stateBlock state;
+    Player p1 = Player(1);
+    Player p2 = Player(2);
+    Pile trash = Pile(TRASH);
+    state.p1 = &p1;
+    state.p2 = &p2;
+    state.trash = &trash;
+    state.p1Decider = &bot;
+    p2.DeckPtr()->EmptyDeck();
+    p2.DiscardPtr()->EmptyDeck();
+    p2.AddToDeck(CARD_SILVER);
+    lookup::ThiefEffect(&state, true);
+    EXPECT_EQ(bot.asked[DEC_THIEF_TRASH], 1);
+    EXPECT_EQ(p2.GetDeck().Size(), 0);
+    EXPECT_EQ(p2.GetDiscard().GetCards(), vector<CardId>({CARD_SILVER}));
+    EXPECT_EQ(trash.Size(), 0);
+}
+
+TEST(Decision, throneroomTakesCardFromHand) {
+    // A Throne Room on a Throne Room plays the second one twice, and
+    // neither can pick itself again
+    BotDecider bot;
+    struct stateBlock state;
+    Player p1 = Player(1);
+    Pile trash = Pile(TRASH);
+    state.p1 = &p1;
+    state.trash = &trash;
+    state.p1Decider = &bot;
+    p1.DeckPtr()->EmptyDeck();
+    p1.HandPtr()->EmptyDeck();
+    p1.AddToHand(CARD_THRONEROOM);
+    p1.AddToHand(CARD_VILLAGE);
+    p1.AddToHand(CARD_COPPER);
+    int actions = p1.GetActions();
+    lookup::ThroneroomEffect(&state, true);
+    EXPECT_EQ(p1.GetHand().GetCards(), vector<CardId>({CARD_COPPER}));
+    EXPECT_EQ(p1.GetInPlay().Count(CARD_THRONEROOM), 1);
+    EXPECT_EQ(p1.GetInPlay().Count(CARD_VILLAGE), 1);
+    EXPECT_EQ(p1.GetActions(), actions + 4);
+}
+
+TEST(Headless, botGameWritesNothing) {
+    vector<CardId> cardSet = {CARD_CELLAR, CARD_CHAPEL, CARD_WORKSHOP,
+                              CARD_FEAST, CARD_MILITIA, CARD_MONEYLENDER,
+                              CARD_REMODEL, CARD_THRONEROOM, CARD_LIBRARY,
+                              CARD_MINE};
+    GameArena arena;
+    std::ostringstream captured;
+    std::streambuf *out = std::cout.rdbuf(captured.rdbuf());
+    PlayBotGame(&arena, 5, cardSet);
+    std::cout.rdbuf(out);
+    EXPECT_EQ(captured.str(), "");
+    EXPECT_FALSE(game_state::IsHeadless());
+}
+
+TEST(Headless, sinkGetsHumanText) {
+    BotDecider bot;
+    struct stateBlock state;
+    Player p1 = Player(1);
+    Player p2 = Player(2);
+    state.p1 = &p1;
+    state.p2 = &p2;
+    state.p2Decider = &bot;
+    std::ostringstream sink;
+    std::ostringstream captured;
+    std::streambuf *out = std::cout.rdbuf(captured.rdbuf());
+    game_state::SetOutput(&sink);
+    lookup::MilitiaEffect(&state, true);
+    game_state::SetOutput(&std::cout);
+    std::cout.rdbuf(out);
+    EXPECT_NE(sink.str().find("discard down to 3"), std::string::npos);
+    EXPECT_EQ(captured.str(), "");
+}
+
+TEST(Protocol, roundTrip) {
+    GameArena arena(99);
+    struct stateBlock *state = arena.GetState();
+    protocol::StateRecord record;
+    protocol::Snapshot(*state, false, &record);
+    record.decision = DEC_REMODEL_GAIN;
+    record.maxCost = 6;
+    record.options = lookup::TREASURE_CARDS;
+    std::string frame;
+    protocol::Encode(record, &frame);
+    ASSERT_EQ(frame.size(), 4 + RECORD_BODY_SIZE);
+    // The length prefix is little-endian
+    EXPECT_EQ((uint8_t)frame[0], RECORD_BODY_SIZE & 0xFF);
+    EXPECT_EQ((uint8_t)frame[1], RECORD_BODY_SIZE >> 8);
+
+    protocol::StateRecord decoded;
+    EXPECT_EQ(protocol::Decode((const uint8_t *)frame.data(), frame.size(),
+                               &decoded), frame.size());
+    EXPECT_EQ(decoded.decision, DEC_REMODEL_GAIN);
+    EXPECT_EQ(decoded.player, 2);
+    EXPECT_EQ(decoded.maxCost, 6);
+    EXPECT_EQ(decoded.options, lookup::TREASURE_CARDS);
+    EXPECT_EQ(decoded.playerScore, 3);
+    for(CardId card = 0; card < NUM_CARDS; card++) {
+        EXPECT_EQ(decoded.hand[card], state->p2->GetHand().Count(card));
+        EXPECT_EQ(decoded.deck[card], state->p2->GetDeck().Count(card));
+        EXPECT_EQ(decoded.supply[card], record.supply[card]);
+    }
+    EXPECT_EQ(decoded.supply[CARD_COPPER], COPPER_PILE_SIZE);
+
+    // Short or foreign data is refused
+    EXPECT_EQ(protocol::Decode((const uint8_t *)frame.data(),
+                               frame.size() - 1, &decoded), 0);
+    frame[4] = PROTOCOL_VERSION + 1;
+    EXPECT_EQ(protocol::Decode((const uint8_t *)frame.data(), frame.size(),
+                               &decoded), 0);
+}
+
+TEST(Protocol, binaryChapel) {
+    struct stateBlock state;
+    Player p1 = Player(1);
+    Player p2 = Player(2);
+    Pile trash = Pile(TRASH);
+    Supply kingdomCards = game_state::GenerateKingdom(
+                                                 lookup::GenAllCards());
+    p1.HandPtr()->EmptyDeck();
+    p1.AddToHand(CARD_ESTATE);
+    p1.AddToHand(CARD_COPPER);
+    p1.AddToHand(CARD_ESTATE);
+    state.p1 = &p1;
+    state.p2 = &p2;
+    state.trash = &trash;
+    state.kingdom = &kingdomCards;
+
+    // Reply: trash two estates
+    std::istringstream in(std::string("\x02\x00\x00", 3));
+    std::ostringstream out;
+    BinaryDecider binary(&in, &out);
+    state.p1Decider = &binary;
+    lookup::ChapelEffect(&state, true);
+
+    EXPECT_EQ(p1.GetHand().Size(), 1);
+    EXPECT_EQ(p1.GetHand().At(0), CARD_COPPER);
+    EXPECT_EQ(trash.Count(CARD_ESTATE), 2);
+
+    protocol::StateRecord asked;
+    std::string sent = out.str();
+    ASSERT_EQ(protocol::Decode((const uint8_t *)sent.data(), sent.size(),
+                               &asked), sent.size());
+    EXPECT_EQ(asked.decision, DEC_CHAPEL);
+    EXPECT_EQ(asked.player, 1);
+    EXPECT_EQ(asked.canDecline, 1);
+    EXPECT_EQ(asked.max, 3);
+    EXPECT_EQ(asked.hand[CARD_ESTATE], 2);
+    EXPECT_EQ(asked.hand[CARD_COPPER], 1);
+}
+
+TEST(Protocol, silentAgentCantStall) {
+    // No replies at all: declinable questions are declined and forced
+    // ones get the first legal answer
+    Player p1 = Player(1);
+    Pile trash = Pile(TRASH);
+    Supply kingdomCards = game_state::GenerateKingdom(
+                                                 lookup::GenAllCards());
+    struct stateBlock state;
+    state.p1 = &p1;
+    state.p2 = &p1;
+    state.trash = &trash;
+    state.kingdom = &kingdomCards;
+    std::istringstream in;
+    std::ostringstream out;
+    BinaryDecider binary(&in, &out);
+    state.p1Decider = &binary;
+
+    lookup::RemodelEffect(&state, true);
+    EXPECT_EQ(trash.Size(), 1);
+    EXPECT_EQ(p1.GetDiscard().Size(), 1);
+    lookup::ChapelEffect(&state, true);
+    EXPECT_EQ(trash.Size(), 1);
+    // Remodel asks twice, chapel once
+    EXPECT_EQ(out.str().size(), 3 * (4 + RECORD_BODY_SIZE));
+}
+
+// Returns the read end of a pipe that holds `text` and then ends
+int PipeHolding(const std::string &text) {
+    int fds[2];
+    if(pipe(fds) == -1 ||
+       write(fds[1], text.data(), text.size()) != (ssize_t)text.size()) {
+        return -1;
+    }
+    close(fds[1]);
+    return fds[0];
+}
+
+TEST(Gsv, deltaAndResync) {
+    GameArena arena(3);
+    arena.SetDeltaGsv(true);
+    struct stateBlock *state = arena.GetState();
+    state->p1->HandPtr()->EmptyDeck();
+    state->p1->AddToHand(CARD_COPPER);
+    state->p1->AddToHand(CARD_ESTATE);
+    // Everything after the first answer is queued, so the delta is only
+    // sent because it is asked for
+    int fd = PipeHolding("copper\nstate?\nresync\n-1\n");
+    InputReader in(fd);
+    decision::SetInput(&in);
+    std::ostringstream captured;
+    std::streambuf *out = std::cout.rdbuf(captured.rdbuf());
+    game_state::TreasurePhase(state, true);
+    std::cout.rdbuf(out);
+    decision::SetInput(NULL);
+    close(fd);
+
+    std::string sent = captured.str();
+    size_t full = sent.find("@@GSV@@: 1\n");
+    size_t delta = sent.find("@@GSV-DELTA@@: 2\n");
+    size_t resent = sent.find("@@GSV@@: 3\n");
+    ASSERT_NE(full, std::string::npos);
+    ASSERT_NE(delta, std::string::npos);
+    ASSERT_NE(resent, std::string::npos);
+    EXPECT_LT(full, delta);
+    EXPECT_LT(delta, resent);
+    // The delta has the coin, the copper leaving the hand and reaching
+    // the discard, and nothing else
+    std::string body = sent.substr(delta, sent.find("@@END OF GSV@@", delta) -
+                                          delta);
+    EXPECT_NE(body.find("*num-coins: 1*"), std::string::npos);
+    EXPECT_NE(body.find("@PLAYER-HAND@\n*copper, 0*"), std::string::npos);
+    EXPECT_NE(body.find("@PLAYER-DISCARD@\n*copper, 1*"),
+              std::string::npos);
+    EXPECT_EQ(body.find("estate"), std::string::npos);
+    EXPECT_EQ(body.find("@KINGDOM@"), std::string::npos);
+    EXPECT_EQ(state->p1->GetCoins(), 1);
+}
+
+TEST(Gsv, emptyPilesLeftOut) {
+    GameArena arena(3);
+    struct stateBlock *state = arena.GetState();
+    GsvLog full;
+    GsvLog delta;
+    delta.SetDelta(true);
+    EXPECT_NE(delta.Next(*state, true, "action").find("*curse, "),
+              std::string::npos);
+    Pile taken(TRASH);
+    int curses = state->kingdom->IndexOf(CARD_CURSE);
+    while(state->kingdom->At(curses).Size() > 0) {
+        state->kingdom->Take(curses, &taken);
+    }
+
+    // A full GSV lists only the piles with cards left; a delta says the
+    // pile has gone with a count of 0
+    std::string sent = full.Next(*state, true, "action");
+    size_t kingdom = sent.find("@KINGDOM@");
+    ASSERT_NE(kingdom, std::string::npos);
+    std::string section = sent.substr(kingdom, sent.find("@TRASH@") -
+                                               kingdom);
+    EXPECT_NE(section.find("*copper, "), std::string::npos);
+    EXPECT_EQ(section.find("curse"), std::string::npos);
+    EXPECT_NE(delta.Next(*state, true, "action").find("*curse, 0*"),
+              std::string::npos);
+}
+
+TEST(Gsv, lazyOnRequest) {
+    GameArena arena(3);
+    arena.SetLazyGsv(true);
+    struct stateBlock *state = arena.GetState();
+    state->p1->HandPtr()->EmptyDeck();
+    state->p1->AddToHand(CARD_COPPER);
+    state->p1->AddToHand(CARD_COPPER);
+    int fd = PipeHolding("copper\nstate?\ncopper\n-1\n");
+    InputReader in(fd);
+    decision::SetInput(&in);
+    std::ostringstream captured;
+    std::streambuf *out = std::cout.rdbuf(captured.rdbuf());
+    game_state::SetOutput(NULL);
+    game_state::TreasurePhase(state, true);
+    game_state::SetOutput(&std::cout);
+    std::cout.rdbuf(out);
+    decision::SetInput(NULL);
+    close(fd);
+
+    // One prompt, as the rest of the answers were queued behind the
+    // first, and one GSV, sent when it was asked for
+    std::string sent = captured.str();
+    std::string gsv = "@@GSV@@";
+    size_t at = sent.find(gsv);
+    ASSERT_NE(at, std::string::npos);
+    EXPECT_EQ(sent.find("@@GSV", at + gsv.size()), std::string::npos);
+    EXPECT_NE(sent.find("*num-coins: 1*", at), std::string::npos);
+    EXPECT_EQ(sent.substr(0, at), "response?\n");
+    size_t prompts = 0;
+    for(size_t i = sent.find("response?"); i != std::string::npos;
+        i = sent.find("response?", i + 1)) {
+        prompts++;
+    }
+    EXPECT_EQ(prompts, 1);
+    EXPECT_EQ(state->p1->GetCoins(), 2);
+}
+
+// Big money's reply to `record`
+std::vector<CardId> BigMoneyReply(const protocol::StateRecord &record) {
+    std::vector<CardId> reply;
+    if(record.decision == DEC_PLAY_TREASURE) {
+        for(CardId card : {CARD_GOLD, CARD_SILVER, CARD_COPPER}) {
+            if(reply.empty() && record.hand[card] > 0) {
+                reply.push_back(card);
+            }
+        }
+    } else if(record.decision == DEC_BUY) {
+        if(record.maxCost >= 8) {
+            reply.push_back(CARD_PROVINCE);
+        } else if(record.maxCost >= 6) {
+            reply.push_back(CARD_GOLD);
+        } else if(record.maxCost >= 3) {
+            reply.push_back(CARD_SILVER);
+        }
+    }
+    return reply;
+}
+
+// Plays big money over the agent end of `name` until the game-over
+// record; returns that record
+protocol::StateRecord PlayShmAgent(const std::string &name) {
+    ShmChannel channel;
+    protocol::StateRecord record;
+    record.decision = DEC_GAME_OVER;
+    record.playerScore = -1;
+    if(!channel.Attach(name)) {
+        return record;
+    }
+    ShmStreamBuf buf(&channel);
+    std::istream in(&buf);
+    std::ostream out(&buf);
+    char frame[4 + RECORD_BODY_SIZE];
+    while(in.read(frame, sizeof(frame)) &&
+          protocol::Decode((const uint8_t *)frame, sizeof(frame), &record) &&
+          record.decision != DEC_GAME_OVER) {
+        std::vector<CardId> reply = BigMoneyReply(record);
+        out.put(reply.size());
+        for(CardId card : reply) {
+            out.put(card);
+        }
+        out.flush();
+    }
+    return record;
+}
+
+TEST(Shm, ringCarriesAGame) {
+    std::string name = "/dominion-test-" + std::to_string(getpid());
+    EXPECT_FALSE(ShmChannel().Attach(name));
+    ShmChannel channel;
+    ASSERT_TRUE(channel.Create(name));
+    protocol::StateRecord last;
+    std::thread agent([&]() { last = PlayShmAgent(name); });
+
+    ShmStreamBuf buf(&channel);
+    std::istream in(&buf);
+    std::ostream out(&buf);
+    BinaryDecider decider(&in, &out);
+    GameArena arena(9);
+    arena.SetDeciders(&decider, &decider);
+    struct stateBlock *state = arena.GetState();
+    game_state::SetOutput(NULL);
+    bool p1Turn = true;
+    int turn = 0;
+    for(; turn < MAX_ARENA_TURNS &&
+        !game_state::GameOver(*state->kingdom); turn++) {
+        game_state::ActionPhase(state, p1Turn);
+        game_state::TreasurePhase(state, p1Turn);
+        game_state::BuyPhase(state, p1Turn);
+        game_state::CleanupPhase(state, p1Turn);
+        p1Turn = !p1Turn;
+    }
+    game_state::SetOutput(&std::cout);
+    decider.GameOver(*state);
+    agent.join();
+
+    // Big money runs the provinces out, a good many records after the
+    // ring first wraps
+    EXPECT_LT(turn, MAX_ARENA_TURNS);
+    EXPECT_EQ(state->kingdom->At(state->kingdom->IndexOf(CARD_PROVINCE))
+                  .Size(), 0);
+    EXPECT_EQ(last.decision, DEC_GAME_OVER);
+    EXPECT_EQ(last.playerScore, state->p1->GetScore());
+    EXPECT_EQ(last.opponentScore, state->p2->GetScore());
+}
+
+TEST(Shm, closedPeerEndsReads) {
+    std::string name = "/dominion-close-" + std::to_string(getpid());
+    ShmChannel engine;
+    ASSERT_TRUE(engine.Create(name));
+    ShmChannel agent;
+    ASSERT_TRUE(agent.Attach(name));
+    const uint8_t sent[3] = {1, 2, 3};
+    ASSERT_TRUE(engine.Write(sent, sizeof(sent)));
+    engine.Close();
+    // What was sent before closing still arrives
+    uint8_t got[8];
+    EXPECT_EQ(agent.Read(got, sizeof(got)), 3);
+    EXPECT_EQ(got[2], 3);
+    EXPECT_EQ(agent.Read(got, sizeof(got)), 0);
+}
+
+void SendReply(int fd, uint32_t game, const std::vector<CardId> &reply) {
+    std::string message;
+    for(int i = 0; i < 4; i++) {
+        message.push_back((char)(game >> (8 * i)));
+    }
+    message.push_back((char)reply.size());
+    message.append(reply.begin(), reply.end());
+    ASSERT_EQ(write(fd, message.data(), message.size()),
+              (ssize_t)message.size());
+}
+
+bool ReadAll(int fd, char *data, size_t size) {
+    while(size > 0) {
+        ssize_t got = read(fd, data, size);
+        if(got <= 0) {
+            return false;
+        }
+        data += got;
+        size -= got;
+    }
+    return true;
+}
+
+TEST(GameServer, multiplexesGames) {
+    std::string path = "/tmp/dominion-test-" + std::to_string(getpid()) +
+                       ".sock";
+    GameServer server(21);
+    ASSERT_TRUE(server.Listen(path));
+    std::thread loop([&]() { server.Run(); });
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path.c_str());
+    ASSERT_EQ(connect(fd, (struct sockaddr *)&addr, sizeof(addr)), 0);
+
+    // Open several games, then answer whichever asks; every record that
+    // arrives is for a game that isn't waiting on us elsewhere
+    const uint32_t numGames = 4;
+    for(uint32_t game = 1; game <= numGames; game++) {
+        SendReply(fd, game, {});
+    }
+    uint32_t finished = 0;
+    int records = 0;
+    char frame[8 + RECORD_BODY_SIZE];
+    std::vector<int> gameOvers(numGames + 1, 0);
+    while(finished < numGames && ReadAll(fd, frame, sizeof(frame))) {
+        uint32_t game = (uint8_t)frame[0] | ((uint8_t)frame[1] << 8) |
+                        ((uint8_t)frame[2] << 16) |
+                        ((uint32_t)(uint8_t)frame[3] << 24);
+        protocol::StateRecord record;
+        ASSERT_EQ(protocol::Decode((const uint8_t *)frame + 4,
+                                   sizeof(frame) - 4, &record),
+                  sizeof(frame) - 4);
+        ASSERT_GE(game, 1);
+        ASSERT_LE(game, numGames);
+        records++;
+        if(record.decision == DEC_GAME_OVER) {
+            gameOvers[game]++;
+            finished++;
+        } else {
+            SendReply(fd, game, BigMoneyReply(record));
+        }
+    }
+    EXPECT_EQ(finished, numGames);
+    for(uint32_t game = 1; game <= numGames; game++) {
+        EXPECT_EQ(gameOvers[game], 1);
+    }
+    EXPECT_GT(records, 100);
+
+    // An agent that leaves mid-game doesn't take the server with it: its
+    // games are destroyed where they wait, and the next agent is served
+    SendReply(fd, 9, {});
+    SendReply(fd, 10, {});
+    ASSERT_TRUE(ReadAll(fd, frame, sizeof(frame)));
+    ASSERT_TRUE(ReadAll(fd, frame, sizeof(frame)));
+    close(fd);
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_EQ(connect(fd, (struct sockaddr *)&addr, sizeof(addr)), 0);
+    SendReply(fd, 9, {});
+    ASSERT_TRUE(ReadAll(fd, frame, sizeof(frame)));
+    close(fd);
+    server.Stop();
+    loop.join();
+}
+
+TEST(GameServer, playsUnderOptions) {
+    std::string path = "/tmp/dominion-options-" + std::to_string(getpid()) +
+                       ".sock";
+    GameOptions options;
+    options.autoTreasures = true;
+    GameServer server(23, options);
+    ASSERT_TRUE(server.Listen(path));
+    std::thread loop([&]() { server.Run(); });
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path.c_str());
+    ASSERT_EQ(connect(fd, (struct sockaddr *)&addr, sizeof(addr)), 0);
+
+    // The treasures play themselves, so the game never asks for one
+    SendReply(fd, 1, {});
+    char frame[8 + RECORD_BODY_SIZE];
+    protocol::StateRecord record;
+    int treasureQuestions = 0;
+    bool over = false;
+    while(!over && ReadAll(fd, frame, sizeof(frame))) {
+        ASSERT_EQ(protocol::Decode((const uint8_t *)frame + 4,
+                                   sizeof(frame) - 4, &record),
+                  sizeof(frame) - 4);
+        treasureQuestions += record.decision == DEC_PLAY_TREASURE;
+        over = record.decision == DEC_GAME_OVER;
+        if(!over) {
+            SendReply(fd, 1, BigMoneyReply(record));
+        }
+    }
+    EXPECT_TRUE(over);
+    EXPECT_EQ(treasureQuestions, 0);
+    close(fd);
+    server.Stop();
+    loop.join();
+}
+
+TEST(GameServer, answersRepliesBeforeHangUp) {
+    std::string path = "/tmp/dominion-hangup-" + std::to_string(getpid()) +
+                       ".sock";
+    GameServer server(22);
+    ASSERT_TRUE(server.Listen(path));
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path.c_str());
+    ASSERT_EQ(connect(fd, (struct sockaddr *)&addr, sizeof(addr)), 0);
+    // Both replies and the hang-up are waiting before the loop starts, so
+    // the server reads them all at once
+    SendReply(fd, 1, {});
+    SendReply(fd, 2, {});
+    ASSERT_EQ(shutdown(fd, SHUT_WR), 0);
+    std::thread loop([&]() { server.Run(); });
+
+    char frame[8 + RECORD_BODY_SIZE];
+    EXPECT_TRUE(ReadAll(fd, frame, sizeof(frame)));
+    EXPECT_TRUE(ReadAll(fd, frame, sizeof(frame)));
+    // Then the connection is closed
+    EXPECT_EQ(read(fd, frame, sizeof(frame)), 0);
+    close(fd);
+    server.Stop();
+    loop.join();
+}
+
+TEST(InputReader, queuedTurnSkipsPrompts) {
+    GameArena arena(3);
+    struct stateBlock *state = arena.GetState();
+    state->p1->HandPtr()->EmptyDeck();
+    state->p1->AddToHand(CARD_COPPER);
+    state->p1->AddToHand(CARD_ESTATE);
+    state->p1->AddToHand(CARD_COPPER);
+    state->p1->AddToHand(CARD_SILVER);
+    // The whole turn in one write: no action, three treasures, a silver
+    int fd = PipeHolding("-1\ncopper copper silver -1\nsilver\n");
+    InputReader in(fd);
+    decision::SetInput(&in);
+    std::ostringstream captured;
+    std::streambuf *out = std::cout.rdbuf(captured.rdbuf());
+    game_state::SetOutput(NULL);
+    game_state::ActionPhase(state, true);
+    game_state::TreasurePhase(state, true);
+    game_state::BuyPhase(state, true);
+    game_state::SetOutput(&std::cout);
+    std::cout.rdbuf(out);
+    decision::SetInput(NULL);
+    close(fd);
+
+    // Only the first question, before anything was read, is prompted
+    std::string sent = captured.str();
+    size_t gsv = sent.find("@@GSV@@");
+    ASSERT_NE(gsv, std::string::npos);
+    EXPECT_EQ(sent.find("@@GSV@@", gsv + 1), std::string::npos);
+    size_t prompt = sent.find("response?");
+    ASSERT_NE(prompt, std::string::npos);
+    EXPECT_EQ(sent.find("response?", prompt + 1), std::string::npos);
+    EXPECT_EQ(state->p1->GetCoins(), 1);
+    EXPECT_EQ(state->p1->GetDiscard().Count(CARD_SILVER), 2);
+    EXPECT_EQ(state->p1->GetHand().Size(), 1);
+}
+
+TEST(InputReader, endedInputFinishesGame) {
+    // Both players are on a stdin that has already closed: the questions
+    // stop being asked instead of prompting forever, and the game ends
+    GameArena arena(5);
+    struct stateBlock *state = arena.GetState();
+    int fd = PipeHolding("");
+    InputReader in(fd);
+    decision::SetInput(&in);
+    std::ostringstream captured;
+    std::streambuf *out = std::cout.rdbuf(captured.rdbuf());
+    game_state::SetOutput(NULL);
+    bool p1Turn = true;
+    int turn = 0;
+    for(; turn < MAX_ARENA_TURNS &&
+        !game_state::GameOver(*state->kingdom); turn++) {
+        game_state::ActionPhase(state, p1Turn);
+        game_state::TreasurePhase(state, p1Turn);
+        game_state::BuyPhase(state, p1Turn);
+        game_state::CleanupPhase(state, p1Turn);
+        p1Turn = !p1Turn;
+    }
+    game_state::SetOutput(&std::cout);
+    std::cout.rdbuf(out);
+    decision::SetInput(NULL);
+    close(fd);
+
+    EXPECT_TRUE(in.AtEnd());
+    EXPECT_LT(turn, MAX_ARENA_TURNS);
+    // Only the first question went out before the input was found closed
+    std::string sent = captured.str();
+    size_t prompt = sent.find("response?");
+    ASSERT_NE(prompt, std::string::npos);
+    EXPECT_EQ(sent.find("response?", prompt + 1), std::string::npos);
+}
+
+TEST(InputReader, multiSelectIsOneLine) {
+    struct stateBlock state;
+    Player p1 = Player(1);
+    Player p2 = Player(2);
+    Pile trash = Pile(TRASH);
+    state.p1 = &p1;
+    state.p2 = &p2;
+    state.trash = &trash;
+    p1.HandPtr()->EmptyDeck();
+    p1.AddToHand(CARD_ESTATE);
+    p1.AddToHand(CARD_COPPER);
+    p1.AddToHand(CARD_ESTATE);
+    p1.AddToHand(CARD_COPPER);
+    // A bad line is asked again whole; the next line is the answer.
+    // Militia wants exactly two, so -1 on its own isn't enough.
+    int fd = PipeHolding("0 x\n2 0\n-1\n4 4\n1 4\n");
+    InputReader in(fd);
+    decision::SetInput(&in);
+    game_state::SetOutput(NULL);
+    lookup::ChapelEffect(&state, true);
+    lookup::MilitiaEffect(&state, true);
+    game_state::SetOutput(&std::cout);
+    decision::SetInput(NULL);
+    close(fd);
+
+    EXPECT_EQ(trash.Count(CARD_ESTATE), 2);
+    EXPECT_EQ(p1.GetHand().Size(), 2);
+    EXPECT_EQ(p1.GetHand().Count(CARD_COPPER), 2);
+    // Player 2 started with five and discarded two
+    EXPECT_EQ(p2.GetHand().Size(), 3);
+    EXPECT_EQ(p2.GetDiscard().Size(), 2);
+}
+
+TEST(InputReader, multiSelectIsAsked) {
+    struct stateBlock state;
+    Player p1 = Player(1);
+    Player p2 = Player(2);
+    Pile trash = Pile(TRASH);
+    state.p1 = &p1;
+    state.p2 = &p2;
+    state.trash = &trash;
+    p1.HandPtr()->EmptyDeck();
+    p1.AddToHand(CARD_ESTATE);
+    p1.AddToHand(CARD_COPPER);
+    p1.AddToHand(CARD_ESTATE);
+    std::ostringstream captured;
+    std::streambuf *out = std::cout.rdbuf(captured.rdbuf());
+    game_state::SetOutput(NULL);
+    // Both answers come in one write: the chapel's question goes out with
+    // the hand, and by the militia's its answer has already arrived
+    int fd = PipeHolding("0 2\n0 1\n");
+    InputReader in(fd);
+    decision::SetInput(&in);
+    lookup::ChapelEffect(&state, true);
+    lookup::MilitiaEffect(&state, true);
+    game_state::SetOutput(&std::cout);
+    std::cout.rdbuf(out);
+    decision::SetInput(NULL);
+    close(fd);
+
+    EXPECT_EQ(captured.str(), PICK_HEADER + std::to_string(DEC_CHAPEL) +
+                              " 0 3 estate copper estate\nresponse?\n");
+    EXPECT_EQ(trash.Count(CARD_ESTATE), 2);
+    EXPECT_EQ(p2.GetHand().Size(), 3);
+}
+
+TEST(InputReader, tokensAndInts) {
+    // Words split on any whitespace, including across reads
+    int fd = PipeHolding("  copper\t-1\r\n\n12x 7 ");
+    InputReader in(fd);
+    EXPECT_EQ(in.NextToken(), "copper");
+    long value = 0;
+    EXPECT_TRUE(InputReader::ParseInt(in.NextToken(), &value));
+    EXPECT_EQ(value, -1);
+    EXPECT_FALSE(InputReader::ParseInt(in.NextToken(), &value));
+    EXPECT_TRUE(InputReader::ParseInt(in.NextToken(), &value));
+    EXPECT_EQ(value, 7);
+    EXPECT_EQ(in.NextToken(), "");
+    EXPECT_EQ(in.NextToken(), "");
+    EXPECT_FALSE(InputReader::ParseInt("", &value));
+    close(fd);
+
+    // Reading answers allocates nothing
+    std::string answers;
+    for(int i = 0; i < 1000; i++) {
+        answers += "chapel 3 ";
+    }
+    fd = PipeHolding(answers);
+    InputReader many(fd);
+    size_t allocsBefore = numAllocs;
+    for(int i = 0; i < 1000; i++) {
+        EXPECT_EQ(lookup::FindCard(many.NextToken()), CARD_CHAPEL);
+        EXPECT_TRUE(InputReader::ParseInt(many.NextToken(), &value));
+    }
+    EXPECT_EQ(numAllocs, allocsBefore);
+    close(fd);
+}
+
+// Says yes to everything, but only after `delayMs`
+class SlowBot : public BotDecider {
+    public:
+        int delayMs;
+        explicit SlowBot(int delay) : delayMs(delay) {}
+        bool ChooseYesNo(const struct stateBlock &, bool, Decision,
+                         CardId) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+            return true;
+        }
+};
+
+TEST(TimeControl, lateAnswersFallBack) {
+    GameArena arena(3);
+    arena.SetTimeControl(20, 0, FALLBACK_HEURISTIC);
+    struct stateBlock *state = arena.GetState();
+    state->p1->HandPtr()->EmptyDeck();
+    state->p1->AddToHand(CARD_ESTATE);
+    state->p1->AddToHand(CARD_SILVER);
+    // The write end stays open, so nothing is ever read but what's sent
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    InputReader in(fds[0]);
+    decision::SetInput(&in);
+    std::ostringstream captured;
+    std::streambuf *out = std::cout.rdbuf(captured.rdbuf());
+    game_state::SetOutput(NULL);
+    // Silence is cut off, and the heuristic buys the most it can
+    int idx = decision::FromSupply(*state, true, DEC_BUY, ALL_CARDS, 5,
+                                   true).Get();
+    ASSERT_GE(idx, 0);
+    EXPECT_EQ(lookup::GetCard(state->kingdom->At(idx).GetTopCard())
+              .GetCost(), 5);
+    EXPECT_EQ(state->p1Clock->GetTimeouts(), 1);
+    // An answer in time is used as it is
+    ASSERT_EQ(write(fds[1], "-1\n", 3), 3);
+    EXPECT_EQ(decision::FromSupply(*state, true, DEC_BUY, ALL_CARDS, 5,
+                                   true).Get(), DEF_CHOICE);
+    EXPECT_EQ(state->p1Clock->GetTimeouts(), 1);
+    // Passing declines; first-legal plays the first treasure
+    arena.SetTimeControl(20, 0, FALLBACK_PASS);
+    EXPECT_EQ(decision::FromHand(*state, true, DEC_PLAY_TREASURE,
+                                 state->p1->GetHand(), lookup::TREASURE_CARDS,
+                                 true).Get(), DEF_CHOICE);
+    arena.SetTimeControl(20, 0, FALLBACK_FIRST_LEGAL);
+    EXPECT_EQ(decision::FromHand(*state, true, DEC_PLAY_TREASURE,
+                                 state->p1->GetHand(), lookup::TREASURE_CARDS,
+                                 true).Get(), 1);
+    EXPECT_EQ(state->p1Clock->GetTimeouts(), 3);
+    game_state::SetOutput(&std::cout);
+    std::cout.rdbuf(out);
+    decision::SetInput(NULL);
+    close(fds[0]);
+    close(fds[1]);
+
+    // Every question came with the budget, and every cut-off was told
+    std::string sent = captured.str();
+    size_t clocks = 0;
+    size_t timeouts = 0;
+    for(size_t at = sent.find(CLOCK_HEADER "20 -1\n");
+        at != std::string::npos;
+        at = sent.find(CLOCK_HEADER "20 -1\n", at + 1)) {
+        clocks++;
+    }
+    for(size_t at = sent.find(TIMEOUT_LINE); at != std::string::npos;
+        at = sent.find(TIMEOUT_LINE, at + 1)) {
+        timeouts++;
+    }
+    EXPECT_EQ(clocks, 4);
+    EXPECT_EQ(timeouts, 3);
+    // A new game starts with a clean record
+    arena.Reset();
+    EXPECT_EQ(state->p1Clock->GetTimeouts(), 0);
+}
+
+TEST(TimeControl, gameBudgetAndSlowBots) {
+    GameArena arena(3);
+    arena.SetTimeControl(0, 30, FALLBACK_PASS);
+    struct stateBlock *state = arena.GetState();
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    InputReader in(fds[0]);
+    decision::SetInput(&in);
+    std::ostringstream captured;
+    std::streambuf *out = std::cout.rdbuf(captured.rdbuf());
+    game_state::SetOutput(NULL);
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(decision::YesNo(*state, true, DEC_MONEYLENDER,
+                                 CARD_COPPER).Get());
+    EXPECT_GE(std::chrono::steady_clock::now() - start,
+              std::chrono::milliseconds(30));
+    // The budget is spent, so every later answer is late
+    EXPECT_EQ(state->p1Clock->GameLeftMs(), 0);
+    EXPECT_FALSE(decision::YesNo(*state, true, DEC_MONEYLENDER,
+                                 CARD_COPPER).Get());
+    EXPECT_EQ(state->p1Clock->GetTimeouts(), 2);
+    // Player 2's budget is their own
+    EXPECT_EQ(state->p2Clock->GameLeftMs(), 30);
+    game_state::SetOutput(&std::cout);
+    std::cout.rdbuf(out);
+    decision::SetInput(NULL);
+    close(fds[0]);
+    close(fds[1]);
+    EXPECT_NE(captured.str().find(CLOCK_HEADER "0 0\n"), std::string::npos);
+
+    // A bot can't be cut off, but its late answer is still replaced
+    SlowBot slow(40);
+    arena.Reset();
+    arena.SetDeciders(&slow, &slow);
+    arena.SetTimeControl(10, 0, FALLBACK_PASS);
+    EXPECT_FALSE(decision::YesNo(*state, true, DEC_MONEYLENDER,
+                                 CARD_COPPER).Get());
+    EXPECT_EQ(state->p1Clock->GetTimeouts(), 1);
+    slow.delayMs = 0;
+    EXPECT_TRUE(decision::YesNo(*state, true, DEC_MONEYLENDER,
+                                 CARD_COPPER).Get());
+    EXPECT_EQ(state->p1Clock->GetTimeouts(), 1);
+}
+
+TEST(TimeControl, spentBudgetEndsGame) {
+    SlowBot slow(0);
+    for(Fallback fallback : {FALLBACK_FIRST_LEGAL, FALLBACK_HEURISTIC}) {
+        GameArena arena(7);
+        arena.SetDeciders(&slow, &slow);
+        arena.SetTimeControl(0, 20, fallback);
+        struct stateBlock *state = arena.GetState();
+        // Each player spends their whole budget on one answer, so the
+        // fallback answers everything after it
+        slow.delayMs = 40;
+        decision::YesNo(*state, true, DEC_MONEYLENDER, CARD_COPPER).Get();
+        decision::YesNo(*state, false, DEC_MONEYLENDER, CARD_COPPER).Get();
+        slow.delayMs = 0;
+        ASSERT_EQ(state->p1Clock->GameLeftMs(), 0);
+        ASSERT_EQ(state->p2Clock->GameLeftMs(), 0);
+        game_state::SetOutput(NULL);
+        bool p1Turn = true;
+        int turn = 0;
+        size_t actionsPlayed = 0;
+        for(; turn < MAX_ARENA_TURNS &&
+            !game_state::GameOver(*state->kingdom); turn++) {
+            Player *player = p1Turn ? state->p1 : state->p2;
+            game_state::ActionPhase(state, p1Turn);
+            actionsPlayed += player->GetInPlay().Size();
+            game_state::TreasurePhase(state, p1Turn);
+            game_state::BuyPhase(state, p1Turn);
+            game_state::CleanupPhase(state, p1Turn);
+            p1Turn = !p1Turn;
+        }
+        game_state::SetOutput(&std::cout);
+        // The fallback buys its way to the end without playing an action
+        EXPECT_LT(turn, MAX_ARENA_TURNS);
+        EXPECT_EQ(actionsPlayed, 0);
+        EXPECT_GT(state->p1Clock->GetTimeouts(), turn / 2);
+    }
+}
+
+// Answers like BotDecider, but leaves every question Pending the first
+// time it is asked, so the game is suspended until the test resumes it
+class SuspendingBot : public BotDecider {
+    public:
+        bool answered = false;
+        bool pending = false;
+        std::coroutine_handle<> parked;
+        bool Pending(void) {
+            pending = !answered;
+            answered = false;
+            return pending;
+        }
+        void Park(std::coroutine_handle<> game) { parked = game; }
+        // Delivers the answer to the question the game is waiting on
+        void Resume(void) {
+            answered = true;
+            std::exchange(parked, {}).resume();
+        }
+};
+
+// Plays the arena's current game with the phases awaited, as a hosted
+// game is, and ends with the number of turns played
+Task<int> PlayAwaitedGame(struct stateBlock *state) {
+    bool p1Turn = true;
+    int turn = 0;
+    for(; turn < MAX_ARENA_TURNS &&
+        !game_state::GameOver(*state->kingdom); turn++) {
+        co_await game_state::ActionPhase(state, p1Turn);
+        co_await game_state::TreasurePhase(state, p1Turn);
+        co_await game_state::BuyPhase(state, p1Turn);
+        game_state::CleanupPhase(state, p1Turn);
+        p1Turn = !p1Turn;
+    }
+    co_return turn;
+}
+
+TEST(Task, suspendedGamesInterleave) {
+    game_state::SetOutput(NULL);
+    // Each game played straight through, one after another
+    vector<int> turns(NUM_SUSPENDED_GAMES);
+    vector<int> scores(NUM_SUSPENDED_GAMES);
+    BotDecider bot;
+    for(int game = 0; game < NUM_SUSPENDED_GAMES; game++) {
+        GameArena arena(game);
+        arena.SetDeciders(&bot, &bot);
+        turns[game] = PlayAwaitedGame(arena.GetState()).Get();
+        scores[game] = arena.GetState()->p1->GetScore() -
+                       arena.GetState()->p2->GetScore();
+    }
+
+    // Once frames have been recycled, awaiting a decision doesn't touch
+    // the heap
+    GameArena arena;
+    arena.SetDeciders(&bot, &bot);
+    struct stateBlock *state = arena.GetState();
+    size_t allocsBefore = numAllocs;
+    for(int i = 0; i < 1000; i++) {
+        decision::FromHand(*state, true, DEC_PLAY_ACTION,
+                           state->p1->GetHand(), lookup::ACTION_CARDS, true);
+        decision::FromSupply(*state, true, DEC_BUY, ALL_CARDS, 5,
+                             true);
+        decision::YesNo(*state, true, DEC_LIBRARY, CARD_SMITHY);
+    }
+    EXPECT_EQ(numAllocs, allocsBefore);
+
+    // The same games all suspended at once on this thread, each waiting
+    // on its first question, then resumed in a different order each round
+    vector<std::unique_ptr<GameArena>> arenas;
+    vector<std::unique_ptr<SuspendingBot>> bots;
+    vector<Task<int>> games;
+    for(int game = 0; game < NUM_SUSPENDED_GAMES; game++) {
+        arenas.emplace_back(new GameArena(game));
+        bots.emplace_back(new SuspendingBot());
+        arenas[game]->SetDeciders(bots[game].get(), bots[game].get());
+        games.push_back(PlayAwaitedGame(arenas[game]->GetState()));
+        EXPECT_FALSE(games[game].Done());
+    }
+    rand_utils::Rng order(7);
+    size_t left = games.size();
+    while(left > 0) {
+        // 7 is coprime to the game count, so this visits every game once
+        left = 0;
+        uint64_t offset = order.Next();
+        for(int i = 0; i < NUM_SUSPENDED_GAMES; i++) {
+            int game = (offset + i * 7) % NUM_SUSPENDED_GAMES;
+            if(!games[game].Done()) {
+                bots[game]->Resume();
+            }
+            left += !games[game].Done();
+        }
+    }
+    for(int game = 0; game < NUM_SUSPENDED_GAMES; game++) {
+        ASSERT_TRUE(games[game].Done());
+        EXPECT_EQ(games[game].Get(), turns[game]);
+        EXPECT_EQ(arenas[game]->GetState()->p1->GetScore() -
+                  arenas[game]->GetState()->p2->GetScore(), scores[game]);
+    }
+    game_state::SetOutput(&std::cout);
+}
+
+TEST(GameArena, steadyStateAllocations) {
+    // Bots play the real phases, headless, every kingdom card in reach.
+    // The first games grow the arena's buffers and the frame pool to
+    // what a game needs; after that no turn touches the heap.
+    GameArena arena;
+    BotDecider bot;
+    arena.SetDeciders(&bot, &bot);
+    game_state::SetOutput(NULL);
+    // Each Throne Room played into another nests one more frame, so the
+    // pool only stops growing once it has held the deepest chain: every
+    // Throne Room in the supply ending in each action card. The bot plays
+    // the first action in hand, so a hand in that order plays the chain;
+    // a Copper and an Estate give the trashing cards something to pick.
+    for(int card = 0; card < NUM_CARDS; card++) {
+        if(!lookup::GetCard((CardId)card).IsAction()) {
+            continue;
+        }
+        arena.Reset();
+        struct stateBlock *state = arena.GetState();
+        state->p1->HandPtr()->EmptyDeck();
+        for(int i = 0; i < PILE_SIZE; i++) {
+            state->p1->AddToHand(CARD_THRONEROOM);
+        }
+        state->p1->AddToHand((CardId)card);
+        state->p1->AddToHand(CARD_COPPER);
+        state->p1->AddToHand(CARD_ESTATE);
+        game_state::ActionPhase(state, true);
+    }
+    size_t liveAllocs = 0;
+    size_t turnAllocs = 0;
+    for(int game = 0; game < NUM_ARENA_GAMES; game++) {
+        arena.Reset();
+        if(game == NUM_WARMUP_GAMES) {
+            liveAllocs = numAllocs - numFrees;
+        }
+        struct stateBlock *state = arena.GetState();
+        bool p1Turn = true;
+        for(int turn = 0; turn < MAX_ARENA_TURNS &&
+            !game_state::GameOver(*state->kingdom); turn++) {
+            size_t allocsBefore = numAllocs;
+            game_state::ActionPhase(state, p1Turn);
+            game_state::TreasurePhase(state, p1Turn);
+            game_state::BuyPhase(state, p1Turn);
+            game_state::CleanupPhase(state, p1Turn);
+            if(game >= NUM_WARMUP_GAMES) {
+                turnAllocs += numAllocs - allocsBefore;
+            }
+            p1Turn = !p1Turn;
+        }
+    }
+    game_state::SetOutput(&std::cout);
+    // No turn touches the heap, and resetting frees the whole game
+    EXPECT_EQ(turnAllocs, 0);
+    EXPECT_EQ(numAllocs - numFrees, liveAllocs);
+}
+
+TEST(GameArena, seedReplaysGame) {
+    GameArena arena1(1234);
+    GameArena arena2(1234);
+    for(int game = 0; game < 3; game++) {
+        struct stateBlock *state1 = arena1.GetState();
+        struct stateBlock *state2 = arena2.GetState();
+        EXPECT_EQ(state1->p1->GetHand().GetCards(),
+                  state2->p1->GetHand().GetCards());
+        EXPECT_EQ(state1->p2->GetDeck().GetCards(),
+                  state2->p2->GetDeck().GetCards());
+        for(size_t i = 0; i < state1->kingdom->Size(); i++) {
+            EXPECT_EQ(state1->kingdom->At(i).GetTopCard(),
+                      state2->kingdom->At(i).GetTopCard());
+        }
+        arena1.Reset();
+        arena2.Reset();
+    }
+}
+
+TEST(GameArena, campaignMatchesAcrossThreads) {
+    const uint64_t seed = 0xCA3;
+    vector<uint64_t> serial(NUM_CAMPAIGN_GAMES);
+    GameArena arena;
+    for(int game = 0; game < NUM_CAMPAIGN_GAMES; game++) {
+        serial[game] = PlayCampaignGame(&arena, seed, game);
+    }
+
+    // Same games, dealt round-robin to threads with their own arenas
+    vector<uint64_t> parallel(NUM_CAMPAIGN_GAMES);
+    vector<std::thread> threads;
+    for(int t = 0; t < NUM_CAMPAIGN_THREADS; t++) {
+        threads.emplace_back([&parallel, seed, t]() {
+            GameArena threadArena;
+            for(int game = t; game < NUM_CAMPAIGN_GAMES;
+                game += NUM_CAMPAIGN_THREADS) {
+                parallel[game] = PlayCampaignGame(&threadArena, seed, game);
+            }
+        });
+    }
+    for(std::thread &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(serial, parallel);
+
+    // Any single game can be replayed on its own
+    GameArena replay;
+    EXPECT_EQ(PlayCampaignGame(&replay, seed, 77), serial[77]);
+    EXPECT_NE(serial[0], serial[1]);
 }
 
 TEST(Player, drawCard) {
     Player p1 = Player(1, "p1");
     p1.DrawCard();
-    EXPECT_EQ(p1.GetHand().size(), 6);
-    EXPECT_EQ(p1.GetDeck().size(), 4);
-    EXPECT_EQ(p1.GetDiscard().size(), 0);
+    EXPECT_EQ(p1.GetHand().Size(), 6);
+    EXPECT_EQ(p1.GetDeck().Size(), 4);
+    EXPECT_EQ(p1.GetDiscard().Size(), 0);
     for(int i = 0; i < 10; i++) {
         p1.DrawCard();
     }
-    EXPECT_EQ(p1.GetHand().size(), 10);
-    EXPECT_EQ(p1.GetDeck().size(), 0);
-    EXPECT_EQ(p1.GetDiscard().size(), 0);
+    EXPECT_EQ(p1.GetHand().Size(), 10);
+    EXPECT_EQ(p1.GetDeck().Size(), 0);
+    EXPECT_EQ(p1.GetDiscard().Size(), 0);
+}
+
+TEST(Player, drawN) {
+    Player p1 = Player(1, "p1");
+    p1.DiscardCard(0);
+    p1.DiscardCard(0);
+    // 5 cards come off the deck, then the 2 discards are reshuffled
+    // underneath and 1 more is drawn
+    p1.DrawN(6);
+    EXPECT_EQ(p1.GetHand().Size(), 9);
+    EXPECT_EQ(p1.GetDeck().Size(), 1);
+    EXPECT_EQ(p1.GetDiscard().Size(), 0);
+
+    // Top-decked cards are the next ones drawn
+    p1.AddToDeck(CARD_GOLD);
+    p1.DrawCard();
+    EXPECT_EQ(p1.GetHand().GetTopCard(), CARD_GOLD);
+}
+
+TEST(Player, score) {
+    Player p1 = Player(1, "p1");
+    EXPECT_EQ(p1.GetNumCards(), 10);
+    EXPECT_EQ(p1.GetScore(), 3);
+    p1.AddToDiscard(CARD_PROVINCE);
+    p1.AddToDeck(CARD_CURSE);
+    EXPECT_EQ(p1.GetScore(), 8);
+    // Gardens counts every card the player owns, in any zone
+    p1.AddToHand(CARD_GARDENS);
+    EXPECT_EQ(p1.GetNumCards(), 13);
+    EXPECT_EQ(p1.GetScore(), 9);
+    p1.DiscardCard(0);
+    EXPECT_EQ(p1.GetScore(), 9);
 }
 
 TEST(Player, discardCard) {
@@ -667,15 +2449,15 @@ TEST(Player, discardCard) {
     p1.DiscardCard(0);
     p1.DiscardCard(0);
     p1.DiscardCard(0);
-    EXPECT_EQ(p1.GetHand().size(), 2);
-    EXPECT_EQ(p1.GetDeck().size(), 5);
-    EXPECT_EQ(p1.GetDiscard().size(), 3);
+    EXPECT_EQ(p1.GetHand().Size(), 2);
+    EXPECT_EQ(p1.GetDeck().Size(), 5);
+    EXPECT_EQ(p1.GetDiscard().Size(), 3);
     for(int i = 0; i < 10; i++) {
         p1.DrawCard();
     }
-    EXPECT_EQ(p1.GetHand().size(), 10);
-    EXPECT_EQ(p1.GetDeck().size(), 0);
-    EXPECT_EQ(p1.GetDiscard().size(), 0);
+    EXPECT_EQ(p1.GetHand().Size(), 10);
+    EXPECT_EQ(p1.GetDeck().Size(), 0);
+    EXPECT_EQ(p1.GetDiscard().Size(), 0);
 }
 
 
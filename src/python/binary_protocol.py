@@ -0,0 +1,93 @@
+import struct
+
+# Reference decoder for the engine's binary protocol (./bin/dominion --binary).
+# The record layout is documented in src/cpp/Protocol.h.
+
+PROTOCOL_VERSION = 1
+DEC_GAME_OVER = 0xFF
+NO_CARD = 0xFF
+
+# Decision codes, in the order of the Decision enum in src/cpp/Decision.h
+DECISIONS = [
+    "play-action", "play-treasure", "buy", "cellar", "chapel", "chancellor",
+    "workshop", "feast", "militia", "moneylender", "remodel-trash",
+    "remodel-gain", "spy-self", "spy-other", "thief-trash", "thief-gain",
+    "throneroom", "library", "mine-trash", "mine-gain"
+]
+
+# Card names by CardId, in the order of the CardId enum in src/cpp/Card.h
+CARDS = [
+    "estate", "duchy", "province", "curse", "copper", "silver", "gold",
+    "cellar", "chapel", "moat", "chancellor", "village", "woodcutter",
+    "workshop", "bureaucrat", "feast", "gardens", "militia", "moneylender",
+    "remodel", "smithy", "spy", "thief", "throneroom", "councilroom",
+    "festival", "laboratory", "library", "market", "mine", "witch",
+    "adventurer"
+]
+
+HEADER = struct.Struct("<BBBBBBBBhhhhhhI")
+ZONES = ["deck", "hand", "discard", "supply", "trash"]
+
+def ReadExactly(stream, size):
+    data = b""
+    while len(data) < size:
+        chunk = stream.read(size - len(data))
+        if not chunk:
+            return None
+        data += chunk
+    return data
+
+def DecodeRecord(body):
+    (version, decision, player, canDecline, least, most, subject, numCards,
+     actions, buys, coins, playerScore, opponentScore, maxCost,
+     options) = HEADER.unpack_from(body, 0)
+    if version != PROTOCOL_VERSION:
+        raise ValueError("unsupported protocol version " + str(version))
+    record = {
+        "decision": decision,
+        "player": player,
+        "can-decline": canDecline == 1,
+        "min": least,
+        "max": most,
+        "subject": subject,
+        "num-actions": actions,
+        "num-buys": buys,
+        "num-coins": coins,
+        "player-score": playerScore,
+        "opponent-score": opponentScore,
+        "max-cost": maxCost,
+        "options": [card for card in range(numCards) if options & (1 << card)]
+    }
+    counts = struct.unpack_from("<" + str(len(ZONES) * numCards) + "H", body,
+                                HEADER.size)
+    for zone in range(len(ZONES)):
+        record[ZONES[zone]] = counts[zone * numCards:(zone + 1) * numCards]
+    return record
+
+def ReadRecord(stream):
+    # Returns the next record as a dict, or None once the engine has exited
+    prefix = ReadExactly(stream, 4)
+    if prefix is None:
+        return None
+    (length,) = struct.unpack("<I", prefix)
+    body = ReadExactly(stream, length)
+    if body is None:
+        return None
+    return DecodeRecord(body)
+
+def WriteReply(stream, values):
+    # values: CardIds for hand/supply choices ([] declines), or [1]/[0]
+    # for yes/no
+    stream.write(struct.pack("<B" + str(len(values)) + "B", len(values),
+                             *values))
+    stream.flush()
+
+def PrintRecord(record):
+    if record["decision"] == DEC_GAME_OVER:
+        print("**game-over**")
+    else:
+        print("**" + DECISIONS[record["decision"]] + "**")
+    for zone in ZONES:
+        cards = [CARDS[card] + " : " + str(count)
+                 for card, count in enumerate(record[zone]) if count > 0]
+        print(zone + ": " + ", ".join(cards))